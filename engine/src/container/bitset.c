@@ -0,0 +1,174 @@
+#include "container/bitset.h"
+
+#include "core/logger.h"
+
+static u64 padded_words(u64 bit_count)
+{
+    u64 words = BITSET_WORDS(bit_count);
+    return (words + BITSET_WORD_ALIGN - 1) & ~(u64)(BITSET_WORD_ALIGN - 1);
+}
+
+u64 ac_bits_count_t(const u64* words, u64 word_count)
+{
+    u64 count = 0;
+    for (u64 i = 0; i < word_count; ++i)
+        count += __builtin_popcountll(words[i]);
+    return count;
+}
+
+void ac_bits_and_t(u64* dest, const u64* a, const u64* b, u64 word_count)
+{
+    for (u64 i = 0; i < word_count; ++i)
+        dest[i] = a[i] & b[i];
+}
+
+void ac_bits_or_t(u64* dest, const u64* a, const u64* b, u64 word_count)
+{
+    for (u64 i = 0; i < word_count; ++i)
+        dest[i] = a[i] | b[i];
+}
+
+void ac_bits_andnot_t(u64* dest, const u64* a, const u64* b, u64 word_count)
+{
+    for (u64 i = 0; i < word_count; ++i)
+        dest[i] = a[i] & ~b[i];
+}
+
+void ac_bits_xor_t(u64* dest, const u64* a, const u64* b, u64 word_count)
+{
+    for (u64 i = 0; i < word_count; ++i)
+        dest[i] = a[i] ^ b[i];
+}
+
+u64 ac_bits_next_t(const u64* words, u64 bit_count, u64 from)
+{
+    if (from >= bit_count)
+        return bit_count;
+
+    u64 index = from / BITSET_WORD_BITS;
+    u64 word_count = BITSET_WORDS(bit_count);
+    // drop the bits below from in the first word.
+    u64 word = words[index] & (~0ull << (from % BITSET_WORD_BITS));
+    for (;;)
+    {
+        if (word)
+        {
+            u64 bit = index * BITSET_WORD_BITS + __builtin_ctzll(word);
+            return bit < bit_count ? bit : bit_count;
+        }
+        if (++index == word_count)
+            return bit_count;
+        word = words[index];
+    }
+}
+
+void ac_bitset_create_t(u64 bit_count, bitset* out_set)
+{
+    if (!out_set)
+        return;
+
+    out_set->bit_count = bit_count;
+    out_set->word_count = padded_words(bit_count);
+    out_set->words = 0;
+    if (out_set->word_count)
+    {
+        // comes back zeroed, every bit starts cleared.
+        out_set->words =
+          ac_allocate_aligned_t(out_set->word_count * sizeof(u64), BITSET_WORD_ALIGN * sizeof(u64), MEMTAG_ARRAY);
+    }
+}
+
+void ac_bitset_destroy_t(bitset* set)
+{
+    if (!set)
+        return;
+
+    if (set->words)
+        ac_free_aligned_t(set->words, set->word_count * sizeof(u64), BITSET_WORD_ALIGN * sizeof(u64), MEMTAG_ARRAY);
+    set->words = 0;
+    set->bit_count = 0;
+    set->word_count = 0;
+}
+
+void ac_bitset_resize_t(bitset* set, u64 bit_count)
+{
+    if (!set)
+        return;
+
+    u64 word_count = padded_words(bit_count);
+    if (word_count != set->word_count)
+    {
+        bitset resized;
+        ac_bitset_create_t(bit_count, &resized);
+        u64 keep = word_count < set->word_count ? word_count : set->word_count;
+        if (keep)
+            ac_copy_memory_t(resized.words, set->words, keep * sizeof(u64));
+        ac_bitset_destroy_t(set);
+        *set = resized;
+    }
+    set->bit_count = bit_count;
+
+    // bits past bit_count stay cleared so count/any and the set-wide ops need no masking.
+    u64 tail = bit_count % BITSET_WORD_BITS;
+    u64 first_clear = BITSET_WORDS(bit_count);
+    if (tail)
+        set->words[first_clear - 1] &= (1ull << tail) - 1;
+    if (first_clear < set->word_count)
+        ac_zero_memory_t(set->words + first_clear, (set->word_count - first_clear) * sizeof(u64));
+}
+
+void ac_bitset_clear_all_t(bitset* set)
+{
+    if (set && set->words)
+        ac_zero_memory_t(set->words, set->word_count * sizeof(u64));
+}
+
+u64 ac_bitset_count_t(const bitset* set)
+{
+    return set ? ac_bits_count_t(set->words, set->word_count) : 0;
+}
+
+b8 ac_bitset_any_t(const bitset* set)
+{
+    if (!set)
+        return FALSE;
+
+    u64 any = 0;
+    for (u64 i = 0; i < set->word_count; ++i)
+        any |= set->words[i];
+    return any != 0;
+}
+
+static b8 same_size(const char* func, const bitset* dest, const bitset* a, const bitset* b)
+{
+    if (!dest || !a || !b || dest->bit_count != a->bit_count || a->bit_count != b->bit_count)
+    {
+        ACERROR("%s - bitsets must have the same size.", func);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+b8 ac_bitset_and_t(bitset* dest, const bitset* a, const bitset* b)
+{
+    if (!same_size("ac_bitset_and_t", dest, a, b))
+        return FALSE;
+    ac_bits_and_t(dest->words, a->words, b->words, dest->word_count);
+    return TRUE;
+}
+
+b8 ac_bitset_or_t(bitset* dest, const bitset* a, const bitset* b)
+{
+    if (!same_size("ac_bitset_or_t", dest, a, b))
+        return FALSE;
+    ac_bits_or_t(dest->words, a->words, b->words, dest->word_count);
+    return TRUE;
+}
+
+b8 ac_bitset_andnot_t(bitset* dest, const bitset* a, const bitset* b)
+{
+    if (!same_size("ac_bitset_andnot_t", dest, a, b))
+        return FALSE;
+    ac_bits_andnot_t(dest->words, a->words, b->words, dest->word_count);
+    return TRUE;
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "define.h"
+#include "core/acmemory.h"
+
+/* PERF:
+ * One bit per element packed in u64 words: 64 flags per word instead of one
+ * per b8, so a whole set usually sits in a couple of cache lines. Set-wide
+ * operations (and/or/andnot/count) run a word at a time over word arrays
+ * padded to BITSET_WORD_ALIGN words, so the compiler vectorizes them with no
+ * tail loop. Iterating set bits skips 64 clear bits per zero word and finds the
+ * next bit with one count-trailing-zeros instruction.
+ * +--------------------+--------------------+-----+------------------+
+ * | word 0 (bits 0-63) | word 1 (64-127)    | ... | padding (zeroed) |
+ * +--------------------+--------------------+-----+------------------+
+ *
+ * The ac_bits_*_t helpers work on any u64 array (e.g. a fixed u64[BITSET_WORDS(256)]
+ * inside a struct), bitset owns a heap array of bit_count bits.
+ */
+
+#define BITSET_WORD_BITS 64
+#define BITSET_WORD_ALIGN 4 // words, 256 bits: one AVX2 register.
+
+// u64 words needed for bit_count bits.
+#define BITSET_WORDS(bit_count) (((bit_count) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+
+static inline void ac_bits_set_t(u64* words, u64 bit)
+{
+    words[bit / BITSET_WORD_BITS] |= 1ull << (bit % BITSET_WORD_BITS);
+}
+
+static inline void ac_bits_clear_t(u64* words, u64 bit)
+{
+    words[bit / BITSET_WORD_BITS] &= ~(1ull << (bit % BITSET_WORD_BITS));
+}
+
+static inline void ac_bits_assign_t(u64* words, u64 bit, b8 value)
+{
+    u64 mask = 1ull << (bit % BITSET_WORD_BITS);
+    u64* word = &words[bit / BITSET_WORD_BITS];
+    *word = (*word & ~mask) | (value ? mask : 0);
+}
+
+static inline b8 ac_bits_test_t(const u64* words, u64 bit)
+{
+    return (words[bit / BITSET_WORD_BITS] >> (bit % BITSET_WORD_BITS)) & 1;
+}
+
+// Number of set bits in words[0 .. word_count).
+ACAPI u64 ac_bits_count_t(const u64* words, u64 word_count);
+
+// dest = a op b over word_count words. dest may be a or b.
+ACAPI void ac_bits_and_t(u64* dest, const u64* a, const u64* b, u64 word_count);
+ACAPI void ac_bits_or_t(u64* dest, const u64* a, const u64* b, u64 word_count);
+ACAPI void ac_bits_andnot_t(u64* dest, const u64* a, const u64* b, u64 word_count); // a & ~b
+ACAPI void ac_bits_xor_t(u64* dest, const u64* a, const u64* b, u64 word_count);
+
+/* INFO:
+ * Returns: First set bit >= from, or bit_count if there is none.
+ * Iterates every set bit:
+ *   for (u64 bit = ac_bits_next_t(words, bit_count, 0); bit < bit_count; bit = ac_bits_next_t(words, bit_count, bit + 1))
+ */
+ACAPI u64 ac_bits_next_t(const u64* words, u64 bit_count, u64 from);
+
+typedef struct bitset
+{
+    u64* words;
+    u64 bit_count;
+    u64 word_count; // padded to BITSET_WORD_ALIGN.
+} bitset;
+
+// Creates a bitset of bit_count cleared bits.
+ACAPI void ac_bitset_create_t(u64 bit_count, bitset* out_set);
+ACAPI void ac_bitset_destroy_t(bitset* set);
+
+// Grows or shrinks to bit_count bits, new bits are cleared.
+ACAPI void ac_bitset_resize_t(bitset* set, u64 bit_count);
+ACAPI void ac_bitset_clear_all_t(bitset* set);
+
+ACAPI u64 ac_bitset_count_t(const bitset* set);
+ACAPI b8 ac_bitset_any_t(const bitset* set);
+
+/* INFO:
+ * dest = a op b. All three must have the same bit_count, dest may be a or b.
+ * Returns FALSE without touching dest if the sizes differ.
+ */
+ACAPI b8 ac_bitset_and_t(bitset* dest, const bitset* a, const bitset* b);
+ACAPI b8 ac_bitset_or_t(bitset* dest, const bitset* a, const bitset* b);
+ACAPI b8 ac_bitset_andnot_t(bitset* dest, const bitset* a, const bitset* b);
+
+#define ac_bitset_set_t(set, bit) ac_bits_set_t((set)->words, bit)
+#define ac_bitset_clear_t(set, bit) ac_bits_clear_t((set)->words, bit)
+#define ac_bitset_assign_t(set, bit, value) ac_bits_assign_t((set)->words, bit, value)
+#define ac_bitset_test_t(set, bit) ac_bits_test_t((set)->words, bit)
+#define ac_bitset_next_t(set, from) ac_bits_next_t((set)->words, (set)->bit_count, from)
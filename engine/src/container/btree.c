@@ -0,0 +1,564 @@
+#include "container/btree.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+// number of keys < key, the insert position in a leaf.
+static inline u32 node_lower_bound(const btree_node* node, u64 key)
+{
+    u32 index = 0;
+    for (u32 i = 0; i < node->count; ++i)
+        index += node->keys[i] < key;
+    return index;
+}
+
+// number of keys <= key, the child of an inner node that covers key.
+static inline u32 node_child_index(const btree_node* node, u64 key)
+{
+    u32 index = 0;
+    for (u32 i = 0; i < node->count; ++i)
+        index += node->keys[i] <= key;
+    return index;
+}
+
+// cannot fail, ac_btree_insert_t reserves the nodes an insert may need up front.
+static btree_node* node_create(btree* tree, b8 leaf)
+{
+    btree_node* node = ac_pool_alloc_allocate_t(&tree->nodes);
+    node->leaf = leaf;
+    return node;
+}
+
+static void node_destroy_recursive(btree* tree, btree_node* node)
+{
+    if (!node->leaf)
+    {
+        for (u32 i = 0; i <= node->count; ++i)
+            node_destroy_recursive(tree, node->children[i]);
+    }
+    ac_pool_alloc_free_t(&tree->nodes, node);
+}
+
+static btree_node* find_leaf(const btree* tree, u64 key)
+{
+    btree_node* node = tree->root;
+    while (node && !node->leaf)
+        node = node->children[node_child_index(node, key)];
+    return node;
+}
+
+void ac_btree_create_t(btree* out_tree)
+{
+    if (!out_tree)
+        return;
+
+    ac_zero_memory_t(out_tree, sizeof(btree));
+    ac_pool_alloc_create_type_t("btree", btree_node, BTREE_NODES_PER_CHUNK, MEMTAG_BST, &out_tree->nodes);
+}
+
+void ac_btree_destroy_t(btree* tree)
+{
+    if (!tree)
+        return;
+
+    ac_btree_clear_t(tree);
+    ac_pool_alloc_destroy_t(&tree->nodes);
+}
+
+void ac_btree_clear_t(btree* tree)
+{
+    if (!tree || !tree->root)
+        return;
+
+    node_destroy_recursive(tree, tree->root);
+    tree->root = 0;
+    tree->count = 0;
+    tree->height = 0;
+}
+
+// ----------------- insert --------------------
+
+typedef enum insert_result
+{
+    INSERT_REPLACED,
+    INSERT_ADDED,
+    INSERT_SPLIT, // added and the node split, out_key/out_right go to the parent.
+} insert_result;
+
+static insert_result leaf_insert(btree* tree, btree_node* leaf, u64 key, u64 value, u64* out_key, btree_node** out_right)
+{
+    u32 pos = node_lower_bound(leaf, key);
+    if (pos < leaf->count && leaf->keys[pos] == key)
+    {
+        leaf->values[pos] = value;
+        return INSERT_REPLACED;
+    }
+
+    insert_result result = INSERT_ADDED;
+    btree_node* target = leaf;
+    if (leaf->count == BTREE_NODE_KEYS)
+    {
+        // move the upper half to a new right leaf, then insert into the half that covers key.
+        btree_node* right = node_create(tree, TRUE);
+        u32 keep = (BTREE_NODE_KEYS + 1) / 2;
+        right->count = leaf->count - keep;
+        ac_copy_memory_t(right->keys, leaf->keys + keep, right->count * sizeof(u64));
+        ac_copy_memory_t(right->values, leaf->values + keep, right->count * sizeof(u64));
+        leaf->count = keep;
+        right->next = leaf->next;
+        leaf->next = right;
+
+        if (pos > keep)
+        {
+            target = right;
+            pos -= keep;
+        }
+        *out_right = right;
+        result = INSERT_SPLIT;
+    }
+
+    ac_move_memory_t(target->keys + pos + 1, target->keys + pos, (target->count - pos) * sizeof(u64));
+    ac_move_memory_t(target->values + pos + 1, target->values + pos, (target->count - pos) * sizeof(u64));
+    target->keys[pos] = key;
+    target->values[pos] = value;
+    target->count++;
+
+    if (result == INSERT_SPLIT)
+        *out_key = (*out_right)->keys[0];
+    return result;
+}
+
+static insert_result node_insert(btree* tree, btree_node* node, u64 key, u64 value, u64* out_key, btree_node** out_right)
+{
+    if (node->leaf)
+        return leaf_insert(tree, node, key, value, out_key, out_right);
+
+    u32 child = node_child_index(node, key);
+    u64 split_key;
+    btree_node* split_right;
+    insert_result result = node_insert(tree, node->children[child], key, value, &split_key, &split_right);
+    if (result != INSERT_SPLIT)
+        return result;
+
+    if (node->count < BTREE_NODE_KEYS)
+    {
+        ac_move_memory_t(node->keys + child + 1, node->keys + child, (node->count - child) * sizeof(u64));
+        ac_move_memory_t(node->children + child + 2, node->children + child + 1, (node->count - child) * sizeof(btree_node*));
+        node->keys[child] = split_key;
+        node->children[child + 1] = split_right;
+        node->count++;
+        return INSERT_ADDED;
+    }
+
+    // full: lay out the BTREE_NODE_KEYS + 1 keys in order, the middle one moves up to the parent.
+    u64 keys[BTREE_NODE_KEYS + 1];
+    btree_node* children[BTREE_NODE_KEYS + 2];
+    ac_copy_memory_t(keys, node->keys, child * sizeof(u64));
+    keys[child] = split_key;
+    ac_copy_memory_t(keys + child + 1, node->keys + child, (BTREE_NODE_KEYS - child) * sizeof(u64));
+    ac_copy_memory_t(children, node->children, (child + 1) * sizeof(btree_node*));
+    children[child + 1] = split_right;
+    ac_copy_memory_t(children + child + 2, node->children + child + 1, (BTREE_NODE_KEYS - child) * sizeof(btree_node*));
+
+    u32 middle = (BTREE_NODE_KEYS + 1) / 2;
+    btree_node* right = node_create(tree, FALSE);
+    node->count = middle;
+    ac_copy_memory_t(node->keys, keys, middle * sizeof(u64));
+    ac_copy_memory_t(node->children, children, (middle + 1) * sizeof(btree_node*));
+    right->count = BTREE_NODE_KEYS - middle;
+    ac_copy_memory_t(right->keys, keys + middle + 1, right->count * sizeof(u64));
+    ac_copy_memory_t(right->children, children + middle + 1, (right->count + 1) * sizeof(btree_node*));
+
+    *out_key = keys[middle];
+    *out_right = right;
+    return INSERT_SPLIT;
+}
+
+b8 ac_btree_insert_t(btree* tree, u64 key, u64 value)
+{
+    if (!tree)
+        return FALSE;
+
+    // worst case every level splits and a new root is added. Failing here leaves the tree untouched,
+    // a split half way up could not be undone.
+    if (!ac_pool_alloc_reserve_t(&tree->nodes, tree->height + 1))
+    {
+        ACERROR("ac_btree_insert_t - failed to allocate nodes, key %llu not inserted.", key);
+        return FALSE;
+    }
+
+    if (!tree->root)
+    {
+        tree->root = node_create(tree, TRUE);
+        tree->height = 1;
+    }
+
+    u64 split_key;
+    btree_node* split_right;
+    insert_result result = node_insert(tree, tree->root, key, value, &split_key, &split_right);
+    if (result == INSERT_SPLIT)
+    {
+        btree_node* root = node_create(tree, FALSE);
+        root->count = 1;
+        root->keys[0] = split_key;
+        root->children[0] = tree->root;
+        root->children[1] = split_right;
+        tree->root = root;
+        tree->height++;
+    }
+
+    if (result == INSERT_REPLACED)
+        return FALSE;
+
+    tree->count++;
+    return TRUE;
+}
+
+b8 ac_btree_find_t(const btree* tree, u64 key, u64* out_value)
+{
+    if (!tree)
+        return FALSE;
+
+    btree_node* leaf = find_leaf(tree, key);
+    if (!leaf)
+        return FALSE;
+
+    u32 pos = node_lower_bound(leaf, key);
+    if (pos == leaf->count || leaf->keys[pos] != key)
+        return FALSE;
+
+    if (out_value)
+        *out_value = leaf->values[pos];
+    return TRUE;
+}
+
+// ----------------- erase --------------------
+
+// child of parent at index has less than BTREE_NODE_MIN_KEYS keys: borrow from a sibling or merge with one.
+static void fix_underflow(btree* tree, btree_node* parent, u32 index)
+{
+    btree_node* child = parent->children[index];
+    btree_node* left = index > 0 ? parent->children[index - 1] : 0;
+    btree_node* right = index < parent->count ? parent->children[index + 1] : 0;
+
+    if (left && left->count > BTREE_NODE_MIN_KEYS)
+    {
+        ac_move_memory_t(child->keys + 1, child->keys, child->count * sizeof(u64));
+        if (child->leaf)
+        {
+            ac_move_memory_t(child->values + 1, child->values, child->count * sizeof(u64));
+            child->keys[0] = left->keys[left->count - 1];
+            child->values[0] = left->values[left->count - 1];
+            parent->keys[index - 1] = child->keys[0];
+        }
+        else
+        {
+            ac_move_memory_t(child->children + 1, child->children, (child->count + 1) * sizeof(btree_node*));
+            child->keys[0] = parent->keys[index - 1];
+            child->children[0] = left->children[left->count];
+            parent->keys[index - 1] = left->keys[left->count - 1];
+        }
+        child->count++;
+        left->count--;
+        return;
+    }
+
+    if (right && right->count > BTREE_NODE_MIN_KEYS)
+    {
+        if (child->leaf)
+        {
+            child->keys[child->count] = right->keys[0];
+            child->values[child->count] = right->values[0];
+            ac_move_memory_t(right->values, right->values + 1, (right->count - 1) * sizeof(u64));
+        }
+        else
+        {
+            child->keys[child->count] = parent->keys[index];
+            child->children[child->count + 1] = right->children[0];
+            parent->keys[index] = right->keys[0];
+            ac_move_memory_t(right->children, right->children + 1, right->count * sizeof(btree_node*));
+        }
+        ac_move_memory_t(right->keys, right->keys + 1, (right->count - 1) * sizeof(u64));
+        child->count++;
+        right->count--;
+        if (child->leaf)
+            parent->keys[index] = right->keys[0];
+        return;
+    }
+
+    // both siblings are at the minimum: merge the right one of the pair into the left one.
+    if (!right)
+    {
+        right = child;
+        child = left;
+        index--;
+    }
+
+    if (child->leaf)
+    {
+        ac_copy_memory_t(child->keys + child->count, right->keys, right->count * sizeof(u64));
+        ac_copy_memory_t(child->values + child->count, right->values, right->count * sizeof(u64));
+        child->count += right->count;
+        child->next = right->next;
+    }
+    else
+    {
+        child->keys[child->count] = parent->keys[index];
+        ac_copy_memory_t(child->keys + child->count + 1, right->keys, right->count * sizeof(u64));
+        ac_copy_memory_t(child->children + child->count + 1, right->children, (right->count + 1) * sizeof(btree_node*));
+        child->count += right->count + 1;
+    }
+    ac_pool_alloc_free_t(&tree->nodes, right);
+
+    ac_move_memory_t(parent->keys + index, parent->keys + index + 1, (parent->count - index - 1) * sizeof(u64));
+    ac_move_memory_t(parent->children + index + 1, parent->children + index + 2, (parent->count - index - 1) * sizeof(btree_node*));
+    parent->count--;
+}
+
+static b8 node_erase(btree* tree, btree_node* node, u64 key, u64* out_value)
+{
+    if (node->leaf)
+    {
+        u32 pos = node_lower_bound(node, key);
+        if (pos == node->count || node->keys[pos] != key)
+            return FALSE;
+
+        if (out_value)
+            *out_value = node->values[pos];
+        ac_move_memory_t(node->keys + pos, node->keys + pos + 1, (node->count - pos - 1) * sizeof(u64));
+        ac_move_memory_t(node->values + pos, node->values + pos + 1, (node->count - pos - 1) * sizeof(u64));
+        node->count--;
+        return TRUE;
+    }
+
+    u32 child = node_child_index(node, key);
+    if (!node_erase(tree, node->children[child], key, out_value))
+        return FALSE;
+
+    if (node->children[child]->count < BTREE_NODE_MIN_KEYS)
+        fix_underflow(tree, node, child);
+    return TRUE;
+}
+
+b8 ac_btree_erase_t(btree* tree, u64 key, u64* out_value)
+{
+    if (!tree || !tree->root)
+        return FALSE;
+
+    if (!node_erase(tree, tree->root, key, out_value))
+        return FALSE;
+    tree->count--;
+
+    // the root is the only node allowed below the minimum, drop it once it is empty.
+    btree_node* root = tree->root;
+    if (root->count == 0)
+    {
+        tree->root = root->leaf ? 0 : root->children[0];
+        tree->height--;
+        ac_pool_alloc_free_t(&tree->nodes, root);
+    }
+    return TRUE;
+}
+
+// ----------------- iteration --------------------
+
+btree_iterator ac_btree_begin_t(const btree* tree)
+{
+    btree_iterator iterator = { 0, 0 };
+    if (!tree)
+        return iterator;
+
+    btree_node* node = tree->root;
+    while (node && !node->leaf)
+        node = node->children[0];
+    iterator.leaf = node;
+    return iterator;
+}
+
+btree_iterator ac_btree_lower_bound_t(const btree* tree, u64 key)
+{
+    btree_iterator iterator = { 0, 0 };
+    if (!tree)
+        return iterator;
+
+    // the first key >= key may be at the start of the next leaf, next() steps over.
+    iterator.leaf = find_leaf(tree, key);
+    if (iterator.leaf)
+        iterator.index = node_lower_bound(iterator.leaf, key);
+    return iterator;
+}
+
+b8 ac_btree_next_t(btree_iterator* iterator, u64* out_key, u64* out_value)
+{
+    if (!iterator)
+        return FALSE;
+
+    while (iterator->leaf && iterator->index >= iterator->leaf->count)
+    {
+        iterator->leaf = iterator->leaf->next;
+        iterator->index = 0;
+    }
+    if (!iterator->leaf)
+        return FALSE;
+
+    if (out_key)
+        *out_key = iterator->leaf->keys[iterator->index];
+    if (out_value)
+        *out_value = iterator->leaf->values[iterator->index];
+    iterator->index++;
+    return TRUE;
+}
+
+// ------------------------ benchmark ------------------------
+
+// the pointer-chasing tree the B+ tree replaces: one heap node per key, unbalanced (random keys keep it shallow).
+typedef struct bst_node
+{
+    u64 key;
+    u64 value;
+    struct bst_node* left;
+    struct bst_node* right;
+} bst_node;
+
+static void bst_insert(bst_node** root, u64 key, u64 value)
+{
+    bst_node** link = root;
+    while (*link)
+    {
+        if (key == (*link)->key)
+        {
+            (*link)->value = value;
+            return;
+        }
+        link = key < (*link)->key ? &(*link)->left : &(*link)->right;
+    }
+
+    bst_node* node = ac_allocate_t(sizeof(bst_node), MEMTAG_BST);
+    node->key = key;
+    node->value = value;
+    *link = node;
+}
+
+static b8 bst_find(const bst_node* node, u64 key, u64* out_value)
+{
+    while (node)
+    {
+        if (key == node->key)
+        {
+            *out_value = node->value;
+            return TRUE;
+        }
+        node = key < node->key ? node->left : node->right;
+    }
+    return FALSE;
+}
+
+static u64 bst_sum(const bst_node* node)
+{
+    return node ? bst_sum(node->left) + node->value + bst_sum(node->right) : 0;
+}
+
+static void bst_destroy(bst_node* node)
+{
+    if (!node)
+        return;
+    bst_destroy(node->left);
+    bst_destroy(node->right);
+    ac_free_t(node, sizeof(bst_node), MEMTAG_BST);
+}
+
+static u64 benchmark_random(u64* seed)
+{
+    // xorshift64*
+    u64 x = *seed;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *seed = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+#define BTREE_BENCHMARK_LOOKUPS 2000000
+
+void ac_btree_benchmark_t()
+{
+    static const u64 counts[] = { 1000, 10000, 100000, 1000000 };
+    u64 seed = 0x9E3779B97F4A7C15ull;
+
+    for (u32 c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c)
+    {
+        u64 count = counts[c];
+        u64* keys = ac_allocate_uninit_t(count * sizeof(u64), MEMTAG_ARRAY);
+        if (!keys)
+        {
+            ACERROR("ac_btree_benchmark_t - failed to allocate %llu keys.", count);
+            return;
+        }
+        for (u64 i = 0; i < count; ++i)
+            keys[i] = benchmark_random(&seed);
+
+        btree tree;
+        ac_btree_create_t(&tree);
+        f64 start = platform_get_absolute_time();
+        for (u64 i = 0; i < count; ++i)
+            ac_btree_insert_t(&tree, keys[i], i);
+        f64 btree_insert = platform_get_absolute_time() - start;
+
+        bst_node* bst = 0;
+        start = platform_get_absolute_time();
+        for (u64 i = 0; i < count; ++i)
+            bst_insert(&bst, keys[i], i);
+        f64 bst_insert_time = platform_get_absolute_time() - start;
+
+        // same random lookup order for both, the sums double as a correctness check.
+        u64 lookup_seed = seed;
+        u64 btree_sum = 0;
+        start = platform_get_absolute_time();
+        for (u64 i = 0; i < BTREE_BENCHMARK_LOOKUPS; ++i)
+        {
+            u64 value = 0;
+            ac_btree_find_t(&tree, keys[benchmark_random(&lookup_seed) % count], &value);
+            btree_sum += value;
+        }
+        f64 btree_find = platform_get_absolute_time() - start;
+
+        lookup_seed = seed;
+        u64 bst_lookup_sum = 0;
+        start = platform_get_absolute_time();
+        for (u64 i = 0; i < BTREE_BENCHMARK_LOOKUPS; ++i)
+        {
+            u64 value = 0;
+            bst_find(bst, keys[benchmark_random(&lookup_seed) % count], &value);
+            bst_lookup_sum += value;
+        }
+        f64 bst_find_time = platform_get_absolute_time() - start;
+
+        u64 btree_walk_sum = 0;
+        start = platform_get_absolute_time();
+        btree_iterator it = ac_btree_begin_t(&tree);
+        u64 key, value;
+        while (ac_btree_next_t(&it, &key, &value))
+            btree_walk_sum += value;
+        f64 btree_walk = platform_get_absolute_time() - start;
+
+        start = platform_get_absolute_time();
+        u64 bst_walk_sum = bst_sum(bst);
+        f64 bst_walk = platform_get_absolute_time() - start;
+
+        b8 ok = btree_sum == bst_lookup_sum && btree_walk_sum == bst_walk_sum;
+        ACINFO("btree %8llu keys: insert %6.1f vs %6.1f ns | find %6.1f vs %6.1f ns | walk %8.3f vs %8.3f ms (btree vs bst)%s",
+               count,
+               btree_insert * 1e9 / (f64)count,
+               bst_insert_time * 1e9 / (f64)count,
+               btree_find * 1e9 / BTREE_BENCHMARK_LOOKUPS,
+               bst_find_time * 1e9 / BTREE_BENCHMARK_LOOKUPS,
+               btree_walk * 1000.0,
+               bst_walk * 1000.0,
+               ok ? "" : " WRONG");
+
+        bst_destroy(bst);
+        ac_btree_destroy_t(&tree);
+        ac_free_t(keys, count * sizeof(u64), MEMTAG_ARRAY);
+    }
+}
@@ -2,23 +2,67 @@
 #include "core/acmemory.h"
 #include "core/logger.h"
 
-void* _array_create(u64 length, u64 stride)
+static void* array_allocate(u64 length, u64 stride, b8 zeroed)
 {
     u64 size_header = DYN_ARRAY_FIELD_LENGTH * sizeof(u64);
     u64 size_array = length * stride;
 
-    u64* array = ac_allocate_t(size_header + size_array, MEMTAG_DYN_ARRAY);
-    ac_set_memory_t(array, 0, size_header + size_array);
+    u64* array;
+    if (zeroed)
+        array = ac_allocate_t(size_header + size_array, MEMTAG_DYN_ARRAY);
+    else
+        array = ac_allocate_uninit_t(size_header + size_array, MEMTAG_DYN_ARRAY);
+    // refused by a MEMTAG_DYN_ARRAY hard budget.
+    if (!array)
+        return 0;
 
     // this way was a way to only return the array itself.
     array[DYN_ARRAY_CAPACITY] = length;
     array[DYN_ARRAY_LENGTH] = 0;
     array[DYN_ARRAY_STRIDE] = stride;
-
+    array[DYN_ARRAY_GROWTH] = DYN_ARRAY_DEF_GROWTH;
 
     return (void*)(array + DYN_ARRAY_FIELD_LENGTH);
 }
 
+// moves the elements into a block of new_capacity, keeping length and growth.
+// If the block can't be allocated the array is returned as it was.
+static void* array_reallocate(void* array, u64 new_capacity)
+{
+    u64 length = ac_dyn_array_length_t(array);
+    u64 stride = ac_dyn_array_stride_t(array);
+    u64 growth = _array_get_field(array, DYN_ARRAY_GROWTH);
+
+    // old elements are copied over right away, no need to zero the new block.
+    void* temp = array_allocate(new_capacity, stride, FALSE);
+    if (!temp)
+    {
+        ACERROR("dyn_array - failed to grow to %llu elements, array left as is.", new_capacity);
+        return array;
+    }
+    ac_copy_memory_t(temp, array, length * stride);
+
+    _array_set_field(temp, DYN_ARRAY_LENGTH, length);
+    _array_set_field(temp, DYN_ARRAY_GROWTH, growth);
+    _array_destroy(array);
+    return temp;
+}
+
+// capacity after growing to hold at least required elements.
+static u64 array_grown_capacity(void* array, u64 required)
+{
+    u64 capacity = ac_dyn_array_capacity_t(array);
+    u64 grown = capacity * _array_get_field(array, DYN_ARRAY_GROWTH) / 100;
+    if (grown <= capacity)
+        grown = capacity + 1;
+    return grown > required ? grown : required;
+}
+
+void* _array_create(u64 length, u64 stride)
+{
+    return array_allocate(length, stride, TRUE);
+}
+
 void _array_destroy(void* array)
 {
     u64* header = (u64*)array - DYN_ARRAY_FIELD_LENGTH;
@@ -40,16 +84,36 @@ void _array_set_field(void* array, u64 field, u64 value)
 }
 
 void* _array_resize(void* array)
+{
+    return array_reallocate(array, array_grown_capacity(array, ac_dyn_array_capacity_t(array) + 1));
+}
+
+void* _array_reserve(void* array, u64 capacity)
+{
+    if (capacity <= ac_dyn_array_capacity_t(array))
+        return array;
+
+    return array_reallocate(array, capacity);
+}
+
+void* _array_shrink_to_fit(void* array)
 {
     u64 length = ac_dyn_array_length_t(array);
-    u64 stride = ac_dyn_array_stride_t(array);
+    u64 capacity = length > DYN_ARRAY_DEF_CAPACITY ? length : DYN_ARRAY_DEF_CAPACITY;
+    if (capacity >= ac_dyn_array_capacity_t(array))
+        return array;
 
-    void* temp = _array_create(DYN_ARRAY_RESIZE_FACTOR * ac_dyn_array_capacity_t(array), stride);
-    ac_copy_memory_t(temp, array, length * stride);
+    return array_reallocate(array, capacity);
+}
 
-    _array_set_field(temp, DYN_ARRAY_LENGTH, length);
-    _array_destroy(array);
-    return temp;
+void _array_set_growth(void* array, u64 percent)
+{
+    if (percent <= 100)
+    {
+        ACWARN("_array_set_growth - growth must be above 100%% to grow, got %llu%%. Ignored.", percent);
+        return;
+    }
+    _array_set_field(array, DYN_ARRAY_GROWTH, percent);
 }
 
 void* _array_push(void* array, const void* value_ptr)
@@ -57,15 +121,43 @@ void* _array_push(void* array, const void* value_ptr)
     u64 length = ac_dyn_array_length_t(array);
     u64 stride = ac_dyn_array_stride_t(array);
     if (length >= ac_dyn_array_capacity_t(array))
+    {
         array = _array_resize(array);
+        if (length >= ac_dyn_array_capacity_t(array))
+            return array;
+    }
 
     u64 address = (u64)array;
     address += (length * stride);
-    ac_copy_memory_t((void*)address, value_ptr, stride);
+    ac_copy_memory_small_t((void*)address, value_ptr, stride);
     _array_set_field(array, DYN_ARRAY_LENGTH, length + 1);
     return array;
 }
 
+void* _array_push_n(void* array, const void* values_ptr, u64 count)
+{
+    if (count == 0)
+        return array;
+
+    u64 length = ac_dyn_array_length_t(array);
+    u64 stride = ac_dyn_array_stride_t(array);
+    if (length + count > ac_dyn_array_capacity_t(array))
+    {
+        // values may live in the array itself (appending to self), find them again after the move.
+        u64 offset = (u64)values_ptr - (u64)array;
+        b8 inside = (u64)values_ptr >= (u64)array && offset < length * stride;
+        array = array_reallocate(array, array_grown_capacity(array, length + count));
+        if (length + count > ac_dyn_array_capacity_t(array))
+            return array;
+        if (inside)
+            values_ptr = (u8*)array + offset;
+    }
+
+    ac_copy_memory_t((u8*)array + length * stride, values_ptr, count * stride);
+    _array_set_field(array, DYN_ARRAY_LENGTH, length + count);
+    return array;
+}
+
 void _array_pop(void* array, void* dest)
 {
     u64 length = ac_dyn_array_length_t(array);
@@ -73,7 +165,7 @@ void _array_pop(void* array, void* dest)
     u64 address = (u64)array;
 
     address += ((length - 1) * stride);
-    ac_copy_memory_t(dest, (void*)address, stride);
+    ac_copy_memory_small_t(dest, (void*)address, stride);
     _array_set_field(array, DYN_ARRAY_LENGTH, length - 1);
 }
 
@@ -83,15 +175,16 @@ void* _array_pop_at(void* array, u64 index, void* dest)
     u64 stride = ac_dyn_array_stride_t(array);
     if (index >= length)
     {
-        ACERROR("Index outside of bounds! Length: %i, index: %index", length, index);
+        ACERROR("Index outside of bounds! Length: %llu, index: %llu", length, index);
         return array;
     }
 
-    u64 address = (u64)array;
-    ac_copy_memory_t(dest, (void*)(address + (index * stride)), stride);
+    u8* element = (u8*)array + index * stride;
+    if (dest)
+        ac_copy_memory_small_t(dest, element, stride);
 
-    if (index != length - 1)
-        ac_copy_memory_t((void*)(address + (index * stride)), (void*)(address + ((index + 1) * stride)), stride * (length - index));
+    // close the gap, the ranges overlap.
+    ac_move_memory_t(element, element + stride, stride * (length - index - 1));
 
     _array_set_field(array, DYN_ARRAY_LENGTH, length - 1);
     return array;
@@ -101,21 +194,61 @@ void* _array_insert_at(void* array, u64 index, void* value_ptr)
 {
     u64 length = ac_dyn_array_length_t(array);
     u64 stride = ac_dyn_array_stride_t(array);
-    if (index >= length)
+    if (index > length)
     {
-        ACERROR("Index outside of bounds! Length: %i, index: %index", length, index);
+        ACERROR("Index outside of bounds! Length: %llu, index: %llu", length, index);
         return array;
     }
     if (length >= ac_dyn_array_capacity_t(array))
+    {
         array = _array_resize(array);
+        if (length >= ac_dyn_array_capacity_t(array))
+            return array;
+    }
 
-    u64 address = (u64)array;
+    // open a gap at index, the ranges overlap.
+    u8* element = (u8*)array + index * stride;
+    ac_move_memory_t(element + stride, element, stride * (length - index));
+    ac_copy_memory_small_t(element, value_ptr, stride);
+
+    _array_set_field(array, DYN_ARRAY_LENGTH, length + 1);
+    return array;
+}
+
+void* _array_swap_remove(void* array, u64 index, void* dest)
+{
+    u64 length = ac_dyn_array_length_t(array);
+    u64 stride = ac_dyn_array_stride_t(array);
+    if (index >= length)
+    {
+        ACERROR("Index outside of bounds! Length: %llu, index: %llu", length, index);
+        return array;
+    }
+
+    u8* element = (u8*)array + index * stride;
+    if (dest)
+        ac_copy_memory_small_t(dest, element, stride);
 
     if (index != length - 1)
-        ac_copy_memory_t((void*)(address + ((index - 1) * stride)), (void*)(address + (index * stride)), stride * (length - index));
+        ac_copy_memory_small_t(element, (u8*)array + (length - 1) * stride, stride);
 
-    ac_copy_memory_t((void*)(address + (index * stride)), value_ptr, stride);
+    _array_set_field(array, DYN_ARRAY_LENGTH, length - 1);
+    return array;
+}
 
-    _array_set_field(array, DYN_ARRAY_LENGTH, length + 1);
+void* _array_erase_range(void* array, u64 index, u64 count)
+{
+    u64 length = ac_dyn_array_length_t(array);
+    u64 stride = ac_dyn_array_stride_t(array);
+    if (index > length || count > length - index)
+    {
+        ACERROR("Range outside of bounds! Length: %llu, index: %llu, count: %llu", length, index, count);
+        return array;
+    }
+
+    u8* element = (u8*)array + index * stride;
+    ac_move_memory_t(element, element + count * stride, stride * (length - index - count));
+
+    _array_set_field(array, DYN_ARRAY_LENGTH, length - count);
     return array;
 }
@@ -4,11 +4,12 @@
 
 /* PERF:
  * Memory Layout
- * +-------------------+------------------+--------------------+------------------+
- * | DYNARRAY_CAPACITY | DYN_ARRAY_LENGTH | DYN_ARRAY_STRIDE   |   void* element  |
- * +-------------------+------------------+--------------------+------------------+
- * |       u64         |       u64        | u64 - size in byte | Actual elements  |
- * +-------------------+------------------+--------------------+------------------+
+ * +-------------------+------------------+--------------------+-----------------------+------------------+
+ * | DYNARRAY_CAPACITY | DYN_ARRAY_LENGTH | DYN_ARRAY_STRIDE   | DYN_ARRAY_GROWTH      |   void* element  |
+ * +-------------------+------------------+--------------------+-----------------------+------------------+
+ * |       u64         |       u64        | u64 - size in byte | u64 - percent on grow | Actual elements  |
+ * +-------------------+------------------+--------------------+-----------------------+------------------+
+ * The 32 byte header keeps elements 16 byte aligned.
  */
 
 enum
@@ -16,6 +17,7 @@ enum
     DYN_ARRAY_CAPACITY,
     DYN_ARRAY_LENGTH,
     DYN_ARRAY_STRIDE,
+    DYN_ARRAY_GROWTH,
     DYN_ARRAY_FIELD_LENGTH
 };
 
@@ -26,16 +28,24 @@ ACAPI u64 _array_get_field(void* array, u64 field);
 ACAPI void _array_set_field(void* array, u64 field, u64 value);
 
 ACAPI void* _array_resize(void* array);
+ACAPI void* _array_reserve(void* array, u64 capacity);
+ACAPI void* _array_shrink_to_fit(void* array);
+ACAPI void _array_set_growth(void* array, u64 percent);
 
 ACAPI void* _array_push(void* array, const void* value_ptr);
+ACAPI void* _array_push_n(void* array, const void* values_ptr, u64 count);
 ACAPI void _array_pop(void* array, void* dest);
 
 ACAPI void* _array_pop_at(void* array, u64 index, void* dest);
 ACAPI void* _array_insert_at(void* array, u64 index, void* value_ptr);
+ACAPI void* _array_swap_remove(void* array, u64 index, void* dest);
+ACAPI void* _array_erase_range(void* array, u64 index, u64 count);
 
 #define DYN_ARRAY_DEF_CAPACITY 1
-#define DYN_ARRAY_RESIZE_FACTOR 2
+// new capacity in percent of the old one when a push runs out of room (200 = double).
+#define DYN_ARRAY_DEF_GROWTH 200
 
+// Returns 0 only when a hard budget on MEMTAG_DYN_ARRAY refuses the block. A push that can't grow is dropped and logged.
 #define ac_dyn_array_create_t(type) _array_create(DYN_ARRAY_DEF_CAPACITY, sizeof(type))
 
 // only set capacity of dynamic array but not length
@@ -43,24 +53,48 @@ ACAPI void* _array_insert_at(void* array, u64 index, void* value_ptr);
 
 #define ac_dyn_array_destroy_t(array) _array_destroy(array)
 
-// ISSUE: still have a bug in this, on both platform even using GCC
 #define ac_dyn_array_push_t(array, value)                                                                                                  \
+    do                                                                                                                                     \
     {                                                                                                                                      \
-        __typeof__(value) temp = value;                                                                                                    \
-        array = _array_push(array, &temp);                                                                                                 \
-    }
+        __typeof__(value) _dyn_array_temp = value;                                                                                         \
+        array = _array_push(array, &_dyn_array_temp);                                                                                      \
+    } while (0)
 
 #define ac_dyn_array_pop_t(array, value_ptr) _array_pop(array, value_ptr)
 
-// ISSUE: still have a bug in this, on both platform even using GCC
+/* INFO:
+ * Pushes count elements from values_ptr, growing the array at most once.
+ * append_range pushes every element of another dyn_array of the same type.
+ */
+#define ac_dyn_array_push_n_t(array, values_ptr, count) array = _array_push_n(array, values_ptr, count)
+#define ac_dyn_array_append_range_t(array, other) array = _array_push_n(array, other, ac_dyn_array_length_t(other))
+
+// grows capacity to at least capacity elements, never shrinks. One allocation instead of log2(n) on later pushes.
+#define ac_dyn_array_reserve_t(array, capacity) array = _array_reserve(array, capacity)
+
+// gives back unused capacity, capacity becomes the length (at least 1).
+#define ac_dyn_array_shrink_to_fit_t(array) array = _array_shrink_to_fit(array)
+
+// percent the capacity grows to when full, e.g. 150 for arrays that grow a lot but should waste less.
+#define ac_dyn_array_growth_set_t(array, percent) _array_set_growth(array, percent)
+
+// index may be equal to the length (append). Elements after index shift up by one.
 #define ac_dyn_array_insert_at_t(array, index, value)                                                                                      \
+    do                                                                                                                                     \
     {                                                                                                                                      \
-        __type__(value) temp = value;                                                                                                      \
-        array = _array_insert_at(array, index, &temp);                                                                                     \
-    }
+        __typeof__(value) _dyn_array_temp = value;                                                                                         \
+        array = _array_insert_at(array, index, &_dyn_array_temp);                                                                          \
+    } while (0)
 
+// removes index keeping the order, O(n). value_ptr can be 0.
 #define ac_dyn_array_pop_at_t(array, index, value_ptr) _array_pop_at(array, index, value_ptr)
 
+// removes index by moving the last element into it, O(1) but does not keep the order. value_ptr can be 0.
+#define ac_dyn_array_swap_remove_t(array, index, value_ptr) _array_swap_remove(array, index, value_ptr)
+
+// removes count elements starting at index with one move, keeping the order.
+#define ac_dyn_array_erase_range_t(array, index, count) _array_erase_range(array, index, count)
+
 #define ac_dyn_array_clear_t(array) _array_set_field(array, DYN_ARRAY_LENGTH, 0)
 
 #define ac_dyn_array_capacity_t(array) _array_get_field(array, DYN_ARRAY_CAPACITY)
@@ -0,0 +1,370 @@
+#include "container/hashmap.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// probe start comes from the high bits, the control byte from the low 7 bits.
+#define HASH_H1(hash) ((hash) >> 7)
+#define HASH_H2(hash) ((u8)((hash) & 0x7F))
+
+static inline u64 hash_mix(u64 value)
+{
+    // murmur3 finalizer, spreads every input bit over the whole hash.
+    value ^= value >> 33;
+    value *= 0xFF51AFD7ED558CCDull;
+    value ^= value >> 33;
+    value *= 0xC4CEB9FE1A85EC53ull;
+    value ^= value >> 33;
+    return value;
+}
+
+u64 ac_hashmap_hash_bytes_t(const void* data, u64 size)
+{
+    const u8* bytes = data;
+    if (size == sizeof(u64))
+    {
+        u64 value;
+        memcpy(&value, bytes, sizeof(value));
+        return hash_mix(value);
+    }
+
+    // FNV-1a, mixed at the end so short keys still use the high bits.
+    u64 hash = 0xCBF29CE484222325ull;
+    for (u64 i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash_mix(hash);
+}
+
+u64 ac_hashmap_hash_string_t(const void* key, u64 key_stride)
+{
+    const char* string = *(const char* const*)key;
+    return ac_hashmap_hash_bytes_t(string, strlen(string));
+}
+
+b8 ac_hashmap_equal_string_t(const void* a, const void* b, u64 key_stride)
+{
+    return strcmp(*(const char* const*)a, *(const char* const*)b) == 0;
+}
+
+static u64 default_hash(const void* key, u64 key_stride)
+{
+    return ac_hashmap_hash_bytes_t(key, key_stride);
+}
+
+static b8 default_equal(const void* a, const void* b, u64 key_stride)
+{
+    return memcmp(a, b, key_stride) == 0;
+}
+
+// largest power of two dividing stride, capped at 16. Used as the field alignment.
+static u64 stride_alignment(u64 stride)
+{
+    if (stride == 0)
+        return 1;
+    u64 alignment = stride & (~stride + 1);
+    return alignment > 16 ? 16 : alignment;
+}
+
+static inline u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline u8* slot_key(const hashmap* map, u64 index)
+{
+    return map->slots + index * map->slot_stride;
+}
+
+static inline u8* slot_value(const hashmap* map, u64 index)
+{
+    return map->slots + index * map->slot_stride + map->value_offset;
+}
+
+static inline void set_ctrl(hashmap* map, u64 index, u8 value)
+{
+    map->ctrl[index] = value;
+    if (index < HASHMAP_GROUP_WIDTH)
+        map->ctrl[map->capacity + index] = value;
+}
+
+/* INFO:
+ * Bit i of the result is set when control byte pos + i matches.
+ */
+#if defined(__SSE2__)
+static inline u32 group_match(const u8* ctrl, u8 h2)
+{
+    __m128i group = _mm_loadu_si128((const __m128i*)ctrl);
+    return (u32)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8((char)h2)));
+}
+
+static inline u32 group_match_empty(const u8* ctrl)
+{
+    // only EMPTY has the high bit set.
+    return (u32)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)ctrl));
+}
+#else
+static inline u32 group_match(const u8* ctrl, u8 h2)
+{
+    u32 bits = 0;
+    for (u32 i = 0; i < HASHMAP_GROUP_WIDTH; ++i)
+        bits |= (u32)(ctrl[i] == h2) << i;
+    return bits;
+}
+
+static inline u32 group_match_empty(const u8* ctrl)
+{
+    u32 bits = 0;
+    for (u32 i = 0; i < HASHMAP_GROUP_WIDTH; ++i)
+        bits |= (u32)(ctrl[i] >> 7) << i;
+    return bits;
+}
+#endif
+
+// FALSE when the block is refused (MEMTAG_DICT hard budget), the map is left empty without slots.
+static b8 map_allocate(hashmap* map, u64 capacity)
+{
+    map->count = 0;
+    u64 slots_size = capacity * map->slot_stride;
+    map->slots = ac_allocate_uninit_t(slots_size + capacity + HASHMAP_GROUP_WIDTH, MEMTAG_DICT);
+    if (!map->slots)
+    {
+        map->capacity = 0;
+        map->ctrl = 0;
+        return FALSE;
+    }
+    map->capacity = capacity;
+    map->ctrl = map->slots + slots_size;
+    ac_set_memory_t(map->ctrl, HASHMAP_CTRL_EMPTY, capacity + HASHMAP_GROUP_WIDTH);
+    return TRUE;
+}
+
+static void map_free(hashmap* map)
+{
+    if (map->slots)
+        ac_free_t(map->slots, map->capacity * map->slot_stride + map->capacity + HASHMAP_GROUP_WIDTH, MEMTAG_DICT);
+    map->slots = 0;
+    map->ctrl = 0;
+}
+
+// index of the slot holding key, or -1.
+static i64 map_find(const hashmap* map, const void* key, u64 hash)
+{
+    u64 mask = map->capacity - 1;
+    u64 pos = HASH_H1(hash) & mask;
+    u8 h2 = HASH_H2(hash);
+    for (;;)
+    {
+        const u8* group = map->ctrl + pos;
+        u32 bits = group_match(group, h2);
+        while (bits)
+        {
+            u64 index = (pos + __builtin_ctz(bits)) & mask;
+            if (map->equal(slot_key(map, index), key, map->key_stride))
+                return (i64)index;
+            bits &= bits - 1;
+        }
+
+        // the key would have been placed before the first empty slot.
+        if (group_match_empty(group))
+            return -1;
+        pos = (pos + HASHMAP_GROUP_WIDTH) & mask;
+    }
+}
+
+// first empty slot on the probe path of hash. The map always has one.
+static u64 map_find_empty(const hashmap* map, u64 hash)
+{
+    u64 mask = map->capacity - 1;
+    u64 pos = HASH_H1(hash) & mask;
+    for (;;)
+    {
+        u32 bits = group_match_empty(map->ctrl + pos);
+        if (bits)
+            return (pos + __builtin_ctz(bits)) & mask;
+        pos = (pos + HASHMAP_GROUP_WIDTH) & mask;
+    }
+}
+
+// FALSE when the bigger block is refused, the map keeps its old slots.
+static b8 map_grow(hashmap* map)
+{
+    hashmap old = *map;
+    if (!map_allocate(map, old.capacity * 2))
+    {
+        *map = old;
+        ACERROR("ac_hashmap_insert_t - failed to grow to %llu slots.", old.capacity * 2);
+        return FALSE;
+    }
+
+    for (u64 i = 0; i < old.capacity; ++i)
+    {
+        if (old.ctrl[i] & HASHMAP_CTRL_EMPTY)
+            continue;
+
+        u8* key = slot_key(&old, i);
+        u64 hash = map->hash(key, map->key_stride);
+        u64 index = map_find_empty(map, hash);
+        set_ctrl(map, index, HASH_H2(hash));
+        memcpy(slot_key(map, index), key, map->slot_stride);
+    }
+    map->count = old.count;
+
+    map_free(&old);
+    return TRUE;
+}
+
+void ac_hashmap_create_t(u64 key_stride,
+                         u64 value_stride,
+                         u64 capacity,
+                         pfn_hashmap_hash hash,
+                         pfn_hashmap_equal equal,
+                         hashmap* out_map)
+{
+    if (!out_map)
+        return;
+
+    ac_zero_memory_t(out_map, sizeof(hashmap));
+    if (key_stride == 0)
+    {
+        ACERROR("ac_hashmap_create_t - key_stride must not be 0.");
+        return;
+    }
+
+    u64 key_alignment = stride_alignment(key_stride);
+    u64 value_alignment = stride_alignment(value_stride);
+    out_map->key_stride = key_stride;
+    out_map->value_stride = value_stride;
+    out_map->value_offset = align_up(key_stride, value_alignment);
+    out_map->slot_stride =
+      align_up(out_map->value_offset + value_stride, key_alignment > value_alignment ? key_alignment : value_alignment);
+    out_map->hash = hash ? hash : default_hash;
+    out_map->equal = equal ? equal : default_equal;
+
+    // room for capacity entries under the 7/8 load limit.
+    u64 slots = HASHMAP_MIN_CAPACITY;
+    while (slots * 7 / 8 < capacity)
+        slots *= 2;
+    if (!map_allocate(out_map, slots))
+        ACERROR("ac_hashmap_create_t - failed to allocate %llu slots.", slots);
+}
+
+void ac_hashmap_destroy_t(hashmap* map)
+{
+    if (!map)
+        return;
+
+    map_free(map);
+    map->capacity = 0;
+    map->count = 0;
+}
+
+void* ac_hashmap_insert_t(hashmap* map, const void* key, const void* value)
+{
+    if (!map || !map->slots)
+        return 0;
+
+    u64 hash = map->hash(key, map->key_stride);
+    i64 found = map_find(map, key, hash);
+    if (found >= 0)
+    {
+        if (value)
+            ac_copy_memory_small_t(slot_value(map, found), value, map->value_stride);
+        return slot_value(map, found);
+    }
+
+    if ((map->count + 1) * 8 > map->capacity * 7 && !map_grow(map))
+        return 0;
+
+    u64 index = map_find_empty(map, hash);
+    set_ctrl(map, index, HASH_H2(hash));
+    ac_copy_memory_small_t(slot_key(map, index), key, map->key_stride);
+    if (value)
+        ac_copy_memory_small_t(slot_value(map, index), value, map->value_stride);
+    else
+        ac_zero_memory_t(slot_value(map, index), map->value_stride);
+    map->count++;
+    return slot_value(map, index);
+}
+
+void* ac_hashmap_find_t(const hashmap* map, const void* key)
+{
+    if (!map || !map->slots || map->count == 0)
+        return 0;
+
+    i64 index = map_find(map, key, map->hash(key, map->key_stride));
+    return index >= 0 ? slot_value(map, index) : 0;
+}
+
+b8 ac_hashmap_remove_t(hashmap* map, const void* key, void* out_value)
+{
+    if (!map || !map->slots || map->count == 0)
+        return FALSE;
+
+    i64 found = map_find(map, key, map->hash(key, map->key_stride));
+    if (found < 0)
+        return FALSE;
+
+    if (out_value)
+        ac_copy_memory_small_t(out_value, slot_value(map, found), map->value_stride);
+
+    // backward shift: pull later entries of the same probe run into the hole so
+    // every key stays reachable from its home slot without tombstones.
+    u64 mask = map->capacity - 1;
+    u64 hole = (u64)found;
+    u64 next = (hole + 1) & mask;
+    while (!(map->ctrl[next] & HASHMAP_CTRL_EMPTY))
+    {
+        u64 home = HASH_H1(map->hash(slot_key(map, next), map->key_stride)) & mask;
+        // the entry may move to the hole if the hole is between its home and where it sits.
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            set_ctrl(map, hole, map->ctrl[next]);
+            memcpy(slot_key(map, hole), slot_key(map, next), map->slot_stride);
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    set_ctrl(map, hole, HASHMAP_CTRL_EMPTY);
+    map->count--;
+    return TRUE;
+}
+
+void ac_hashmap_clear_t(hashmap* map)
+{
+    if (!map || !map->slots)
+        return;
+
+    ac_set_memory_t(map->ctrl, HASHMAP_CTRL_EMPTY, map->capacity + HASHMAP_GROUP_WIDTH);
+    map->count = 0;
+}
+
+b8 ac_hashmap_next_t(const hashmap* map, u64* iterator, void** out_key, void** out_value)
+{
+    if (!map || !map->slots || !iterator)
+        return FALSE;
+
+    for (u64 i = *iterator; i < map->capacity; ++i)
+    {
+        if (map->ctrl[i] & HASHMAP_CTRL_EMPTY)
+            continue;
+
+        if (out_key)
+            *out_key = slot_key(map, i);
+        if (out_value)
+            *out_value = slot_value(map, i);
+        *iterator = i + 1;
+        return TRUE;
+    }
+
+    *iterator = map->capacity;
+    return FALSE;
+}
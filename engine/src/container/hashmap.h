@@ -0,0 +1,91 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Open addressing hash map, Swiss table style. Next to the slots sits one
+ * control byte per slot: EMPTY (0x80) or the low 7 bits of the key's hash.
+ * A lookup loads 16 control bytes at once and compares them against those
+ * 7 bits with SSE2, so keys are only compared for likely matches and a probe
+ * usually touches a single cache line of control bytes.
+ * Probing is linear from the home slot, removal shifts the following entries
+ * back instead of leaving tombstones, so lookups never slow down with churn.
+ * +---------------------------------+----------------------------------------+
+ * | slots (capacity * slot_stride)  | ctrl (capacity + HASHMAP_GROUP_WIDTH)  |
+ * +---------------------------------+----------------------------------------+
+ * | key | value | key | value | ... | h2 | EMPTY | h2 | ... | mirror of first |
+ * +---------------------------------+----------------------------------------+
+ * The first HASHMAP_GROUP_WIDTH control bytes are mirrored at the end so a
+ * group load near the end wraps without a branch.
+ */
+
+#define HASHMAP_GROUP_WIDTH 16
+#define HASHMAP_MIN_CAPACITY 16
+#define HASHMAP_CTRL_EMPTY 0x80
+
+// hash of the key_stride bytes at key.
+typedef u64 (*pfn_hashmap_hash)(const void* key, u64 key_stride);
+// TRUE if both keys are equal.
+typedef b8 (*pfn_hashmap_equal)(const void* a, const void* b, u64 key_stride);
+
+typedef struct hashmap
+{
+    u64 key_stride;
+    u64 value_stride;
+    u64 value_offset; // value position inside a slot, keeps values aligned.
+    u64 slot_stride;
+    u64 capacity; // power of two.
+    u64 count;
+    u8* slots;
+    u8* ctrl;
+    pfn_hashmap_hash hash;
+    pfn_hashmap_equal equal;
+} hashmap;
+
+/* INFO:
+ * Creates a hash map.
+ * key_stride/value_stride: Size in bytes of a key/value. value_stride can be 0 for a set.
+ * capacity: Expected number of entries, the map grows past it when needed.
+ * hash/equal: Pass 0 to hash and compare the key bytes. For keys that point to data
+ *             (e.g. const char*) use ac_hashmap_hash_string_t/ac_hashmap_equal_string_t or your own.
+ */
+ACAPI void ac_hashmap_create_t(u64 key_stride,
+                               u64 value_stride,
+                               u64 capacity,
+                               pfn_hashmap_hash hash,
+                               pfn_hashmap_equal equal,
+                               hashmap* out_map);
+ACAPI void ac_hashmap_destroy_t(hashmap* map);
+
+#define ac_hashmap_create_type_t(key_type, value_type, capacity, out_map)                                                                  \
+    ac_hashmap_create_t(sizeof(key_type), sizeof(value_type), capacity, 0, 0, out_map)
+
+/* INFO:
+ * Inserts key with value, or overwrites the value if key is already there.
+ * value: Can be 0 to leave the value zeroed (new key) or untouched (existing key).
+ * Returns: Pointer to the stored value, valid until the next insert or remove.
+ *          0 if the map could not grow (MEMTAG_DICT hard budget), the key is not inserted.
+ */
+ACAPI void* ac_hashmap_insert_t(hashmap* map, const void* key, const void* value);
+
+// Returns: Pointer to the value stored for key, or 0. Valid until the next insert or remove.
+ACAPI void* ac_hashmap_find_t(const hashmap* map, const void* key);
+
+// Removes key, copying its value to out_value when given. Returns FALSE if key was not there.
+ACAPI b8 ac_hashmap_remove_t(hashmap* map, const void* key, void* out_value);
+
+ACAPI void ac_hashmap_clear_t(hashmap* map);
+
+/* INFO:
+ * Walks every entry. Start with *iterator = 0, returns FALSE when done.
+ *
+ * WARN: Inserting or removing while iterating invalidates the iterator.
+ */
+ACAPI b8 ac_hashmap_next_t(const hashmap* map, u64* iterator, void** out_key, void** out_value);
+
+// default byte hash, usable from custom hash functions.
+ACAPI u64 ac_hashmap_hash_bytes_t(const void* data, u64 size);
+
+// hash/equal for keys stored as const char* (the pointer is the key, the string is compared).
+ACAPI u64 ac_hashmap_hash_string_t(const void* key, u64 key_stride);
+ACAPI b8 ac_hashmap_equal_string_t(const void* a, const void* b, u64 key_stride);
@@ -0,0 +1,288 @@
+#include "container/ring_queue.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+
+static u64 round_capacity(u64 capacity)
+{
+    u64 rounded = 1;
+    while (rounded < capacity)
+        rounded <<= 1;
+    return rounded;
+}
+
+static b8 check_params(const char* func, u64 stride, u64 capacity)
+{
+    if (stride == 0 || capacity == 0)
+    {
+        ACERROR("%s - stride and capacity must not be 0.", func);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+// ----------------- single thread --------------------
+
+b8 ac_ring_queue_create_t(u64 stride, u64 capacity, ring_queue* out_queue)
+{
+    if (!out_queue)
+        return FALSE;
+
+    ac_zero_memory_t(out_queue, sizeof(ring_queue));
+    if (!check_params("ac_ring_queue_create_t", stride, capacity))
+        return FALSE;
+
+    out_queue->stride = stride;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->buffer =
+      ac_allocate_aligned_t(out_queue->capacity * stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    if (!out_queue->buffer)
+    {
+        ACERROR("ac_ring_queue_create_t - failed to allocate %llu elements.", out_queue->capacity);
+        ac_zero_memory_t(out_queue, sizeof(ring_queue));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void ac_ring_queue_destroy_t(ring_queue* queue)
+{
+    if (!queue || !queue->buffer)
+        return;
+
+    ac_free_aligned_t(queue->buffer, queue->capacity * queue->stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    ac_zero_memory_t(queue, sizeof(ring_queue));
+}
+
+b8 ac_ring_queue_push_t(ring_queue* queue, const void* element)
+{
+    if (!queue || !queue->buffer || queue->tail - queue->head == queue->capacity)
+        return FALSE;
+
+    ac_copy_memory_small_t(queue->buffer + (queue->tail & queue->mask) * queue->stride, element, queue->stride);
+    queue->tail++;
+    return TRUE;
+}
+
+b8 ac_ring_queue_pop_t(ring_queue* queue, void* out_element)
+{
+    if (!queue || !queue->buffer || queue->tail == queue->head)
+        return FALSE;
+
+    if (out_element)
+        ac_copy_memory_small_t(out_element, queue->buffer + (queue->head & queue->mask) * queue->stride, queue->stride);
+    queue->head++;
+    return TRUE;
+}
+
+void* ac_ring_queue_peek_t(const ring_queue* queue)
+{
+    if (!queue || !queue->buffer || queue->tail == queue->head)
+        return 0;
+
+    return queue->buffer + (queue->head & queue->mask) * queue->stride;
+}
+
+u64 ac_ring_queue_count_t(const ring_queue* queue)
+{
+    return queue ? queue->tail - queue->head : 0;
+}
+
+// ----------------- single producer, single consumer --------------------
+
+b8 ac_ring_queue_spsc_create_t(u64 stride, u64 capacity, ring_queue_spsc* out_queue)
+{
+    if (!out_queue)
+        return FALSE;
+
+    ac_zero_memory_t(out_queue, sizeof(ring_queue_spsc));
+    if (!check_params("ac_ring_queue_spsc_create_t", stride, capacity))
+        return FALSE;
+
+    out_queue->stride = stride;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->buffer =
+      ac_allocate_aligned_t(out_queue->capacity * stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    if (!out_queue->buffer)
+    {
+        ACERROR("ac_ring_queue_spsc_create_t - failed to allocate %llu elements.", out_queue->capacity);
+        // capacity 0 keeps push (full) and pop (empty) away from the buffer.
+        ac_zero_memory_t(out_queue, sizeof(ring_queue_spsc));
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void ac_ring_queue_spsc_destroy_t(ring_queue_spsc* queue)
+{
+    if (!queue || !queue->buffer)
+        return;
+
+    ac_free_aligned_t(queue->buffer, queue->capacity * queue->stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    ac_zero_memory_t(queue, sizeof(ring_queue_spsc));
+}
+
+b8 ac_ring_queue_spsc_push_t(ring_queue_spsc* queue, const void* element)
+{
+    // only the producer writes tail, a relaxed load of our own index is enough.
+    u64 tail = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    if (tail - queue->cached_head == queue->capacity)
+    {
+        queue->cached_head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+        if (tail - queue->cached_head == queue->capacity)
+            return FALSE;
+    }
+
+    ac_copy_memory_small_t(queue->buffer + (tail & queue->mask) * queue->stride, element, queue->stride);
+    // publish the element before the consumer can see the new tail.
+    __atomic_store_n(&queue->tail, tail + 1, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+b8 ac_ring_queue_spsc_pop_t(ring_queue_spsc* queue, void* out_element)
+{
+    u64 head = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    if (head == queue->cached_tail)
+    {
+        queue->cached_tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+        if (head == queue->cached_tail)
+            return FALSE;
+    }
+
+    if (out_element)
+        ac_copy_memory_small_t(out_element, queue->buffer + (head & queue->mask) * queue->stride, queue->stride);
+    // the slot is free for the producer once head moves past it.
+    __atomic_store_n(&queue->head, head + 1, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+u64 ac_ring_queue_spsc_count_t(const ring_queue_spsc* queue)
+{
+    u64 head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    u64 tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    return tail - head;
+}
+
+// ----------------- multi producer, multi consumer --------------------
+
+/* INFO:
+ * Cell i starts with sequence i. For a position pos mapped to the cell:
+ * sequence == pos       the cell is free, a producer may claim pos.
+ * sequence == pos + 1   the cell holds the element of pos, a consumer may claim it.
+ * After popping, the consumer sets sequence to pos + capacity for the next lap.
+ */
+static inline u64* cell_sequence(const ring_queue_mpmc* queue, u64 pos)
+{
+    return (u64*)(queue->cells + (pos & queue->mask) * queue->cell_stride);
+}
+
+b8 ac_ring_queue_mpmc_create_t(u64 stride, u64 capacity, ring_queue_mpmc* out_queue)
+{
+    if (!out_queue)
+        return FALSE;
+
+    ac_zero_memory_t(out_queue, sizeof(ring_queue_mpmc));
+    if (!check_params("ac_ring_queue_mpmc_create_t", stride, capacity))
+        return FALSE;
+
+    out_queue->stride = stride;
+    out_queue->cell_stride = (sizeof(u64) + stride + 7) & ~7ull;
+    out_queue->capacity = round_capacity(capacity);
+    out_queue->mask = out_queue->capacity - 1;
+    out_queue->cells =
+      ac_allocate_aligned_t(out_queue->capacity * out_queue->cell_stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    if (!out_queue->cells)
+    {
+        ACERROR("ac_ring_queue_mpmc_create_t - failed to allocate %llu cells.", out_queue->capacity);
+        ac_zero_memory_t(out_queue, sizeof(ring_queue_mpmc));
+        return FALSE;
+    }
+    for (u64 i = 0; i < out_queue->capacity; ++i)
+        *cell_sequence(out_queue, i) = i;
+    return TRUE;
+}
+
+void ac_ring_queue_mpmc_destroy_t(ring_queue_mpmc* queue)
+{
+    if (!queue || !queue->cells)
+        return;
+
+    ac_free_aligned_t(queue->cells, queue->capacity * queue->cell_stride, ACCACHE_LINE_SIZE, MEMTAG_RING_QUEUE);
+    ac_zero_memory_t(queue, sizeof(ring_queue_mpmc));
+}
+
+b8 ac_ring_queue_mpmc_push_t(ring_queue_mpmc* queue, const void* element)
+{
+    if (!queue->cells)
+        return FALSE;
+
+    u64 pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+    u64* sequence;
+    for (;;)
+    {
+        sequence = cell_sequence(queue, pos);
+        i64 diff = (i64)(__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0)
+        {
+            // on failure pos is reloaded with the current tail.
+            if (__atomic_compare_exchange_n(&queue->tail, &pos, pos + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // the cell still holds the element from the previous lap: full.
+            return FALSE;
+        }
+        else
+        {
+            pos = __atomic_load_n(&queue->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    ac_copy_memory_small_t(sequence + 1, element, queue->stride);
+    __atomic_store_n(sequence, pos + 1, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+b8 ac_ring_queue_mpmc_pop_t(ring_queue_mpmc* queue, void* out_element)
+{
+    if (!queue->cells)
+        return FALSE;
+
+    u64 pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+    u64* sequence;
+    for (;;)
+    {
+        sequence = cell_sequence(queue, pos);
+        i64 diff = (i64)(__atomic_load_n(sequence, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (diff == 0)
+        {
+            if (__atomic_compare_exchange_n(&queue->head, &pos, pos + 1, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // no producer has filled this cell yet: empty.
+            return FALSE;
+        }
+        else
+        {
+            pos = __atomic_load_n(&queue->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (out_element)
+        ac_copy_memory_small_t(out_element, sequence + 1, queue->stride);
+    __atomic_store_n(sequence, pos + queue->capacity, __ATOMIC_RELEASE);
+    return TRUE;
+}
+
+u64 ac_ring_queue_mpmc_count_t(const ring_queue_mpmc* queue)
+{
+    u64 head = __atomic_load_n(&queue->head, __ATOMIC_ACQUIRE);
+    u64 tail = __atomic_load_n(&queue->tail, __ATOMIC_ACQUIRE);
+    // head can pass a stale tail while other threads race.
+    return tail > head ? tail - head : 0;
+}
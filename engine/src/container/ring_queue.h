@@ -0,0 +1,108 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Fixed-capacity FIFO queues over one power-of-two buffer, never allocating
+ * after create. head/tail are free running counters masked on access, so full
+ * and empty need no extra flag and no slot is wasted.
+ * The indices sit on their own cache lines: the producer writes tail and the
+ * consumer writes head, keeping them apart stops the two cores from bouncing
+ * one line between them (false sharing).
+ * +-------------------------+-------------------+-------------------+
+ * | stride/mask/buffer      | head (consumer)   | tail (producer)   |
+ * +-------------------------+-------------------+-------------------+
+ * | read-only after create  | ACCACHE_LINE_SIZE | ACCACHE_LINE_SIZE |
+ * +-------------------------+-------------------+-------------------+
+ *
+ * ring_queue      : single thread, no atomics.
+ * ring_queue_spsc : one producer thread, one consumer thread, lock-free.
+ *                   Each side keeps a cached copy of the other index and only
+ *                   reloads it when the queue looks full/empty.
+ * ring_queue_mpmc : any number of producers and consumers, lock-free and bounded.
+ *                   Every cell carries a sequence number telling whose turn it is
+ *                   (Vyukov's bounded MPMC queue), threads claim a cell with one CAS.
+ */
+
+typedef struct ring_queue
+{
+    u64 stride;
+    u64 capacity; // power of two.
+    u64 mask;
+    u8* buffer;
+
+    ACALIGN(ACCACHE_LINE_SIZE) u64 head;
+    ACALIGN(ACCACHE_LINE_SIZE) u64 tail;
+} ring_queue;
+
+typedef struct ring_queue_spsc
+{
+    u64 stride;
+    u64 capacity;
+    u64 mask;
+    u8* buffer;
+
+    // consumer side.
+    ACALIGN(ACCACHE_LINE_SIZE) u64 head;
+    u64 cached_tail;
+
+    // producer side.
+    ACALIGN(ACCACHE_LINE_SIZE) u64 tail;
+    u64 cached_head;
+} ring_queue_spsc;
+
+typedef struct ring_queue_mpmc
+{
+    u64 stride;
+    u64 cell_stride; // sequence number + element, rounded up to 8 bytes.
+    u64 capacity;
+    u64 mask;
+    u8* cells;
+
+    ACALIGN(ACCACHE_LINE_SIZE) u64 head;
+    ACALIGN(ACCACHE_LINE_SIZE) u64 tail;
+} ring_queue_mpmc;
+
+/* INFO:
+ * Creates a queue. The *_create_t functions all take:
+ * stride: Size in bytes of one element.
+ * capacity: Max number of queued elements, rounded up to a power of two.
+ * out_queue: Queue to initialize. Returns FALSE if stride or capacity is 0 or the buffer can't be
+ *            allocated, the queue is then left empty and every push/pop fails.
+ *
+ * push copies stride bytes in and returns FALSE when full, pop copies the oldest
+ * element to out_element (can be 0 to drop it) and returns FALSE when empty.
+ */
+ACAPI b8 ac_ring_queue_create_t(u64 stride, u64 capacity, ring_queue* out_queue);
+ACAPI void ac_ring_queue_destroy_t(ring_queue* queue);
+ACAPI b8 ac_ring_queue_push_t(ring_queue* queue, const void* element);
+ACAPI b8 ac_ring_queue_pop_t(ring_queue* queue, void* out_element);
+// Returns: Pointer to the oldest element, or 0 when empty. Valid until it is popped.
+ACAPI void* ac_ring_queue_peek_t(const ring_queue* queue);
+ACAPI u64 ac_ring_queue_count_t(const ring_queue* queue);
+
+/* INFO:
+ * push must only be called from one thread and pop from one (other) thread.
+ *
+ * NOTE: count is a snapshot, it can be stale by the time it returns.
+ */
+ACAPI b8 ac_ring_queue_spsc_create_t(u64 stride, u64 capacity, ring_queue_spsc* out_queue);
+ACAPI void ac_ring_queue_spsc_destroy_t(ring_queue_spsc* queue);
+ACAPI b8 ac_ring_queue_spsc_push_t(ring_queue_spsc* queue, const void* element);
+ACAPI b8 ac_ring_queue_spsc_pop_t(ring_queue_spsc* queue, void* out_element);
+ACAPI u64 ac_ring_queue_spsc_count_t(const ring_queue_spsc* queue);
+
+/* INFO:
+ * push and pop can be called from any thread.
+ *
+ * NOTE: count is a snapshot, it can be stale by the time it returns.
+ */
+ACAPI b8 ac_ring_queue_mpmc_create_t(u64 stride, u64 capacity, ring_queue_mpmc* out_queue);
+ACAPI void ac_ring_queue_mpmc_destroy_t(ring_queue_mpmc* queue);
+ACAPI b8 ac_ring_queue_mpmc_push_t(ring_queue_mpmc* queue, const void* element);
+ACAPI b8 ac_ring_queue_mpmc_pop_t(ring_queue_mpmc* queue, void* out_element);
+ACAPI u64 ac_ring_queue_mpmc_count_t(const ring_queue_mpmc* queue);
+
+#define ac_ring_queue_create_type_t(type, capacity, out_queue) ac_ring_queue_create_t(sizeof(type), capacity, out_queue)
+#define ac_ring_queue_spsc_create_type_t(type, capacity, out_queue) ac_ring_queue_spsc_create_t(sizeof(type), capacity, out_queue)
+#define ac_ring_queue_mpmc_create_type_t(type, capacity, out_queue) ac_ring_queue_mpmc_create_t(sizeof(type), capacity, out_queue)
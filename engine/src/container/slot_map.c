@@ -0,0 +1,196 @@
+#include "container/slot_map.h"
+
+#include "core/logger.h"
+
+#define SLOT_MAP_NO_SLOT 0xFFFFFFFFu
+
+static inline u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// dense | slots | dense_slots, each part 16 byte aligned.
+static u64 map_size(u64 stride, u32 capacity)
+{
+    return align_up(stride * capacity, 16) + align_up(sizeof(slot_map_slot) * capacity, 16) + sizeof(u32) * capacity;
+}
+
+// FALSE when the block is refused (hard budget on the map's tag), the map stays as it was.
+static b8 map_resize(slot_map* map, u32 capacity)
+{
+    u8* memory = ac_allocate_uninit_t(map_size(map->stride, capacity), map->tag);
+    if (!memory)
+        return FALSE;
+
+    u8* dense = memory;
+    slot_map_slot* slots = (slot_map_slot*)(dense + align_up(map->stride * capacity, 16));
+    u32* dense_slots = (u32*)((u8*)slots + align_up(sizeof(slot_map_slot) * capacity, 16));
+
+    if (map->dense)
+    {
+        ac_copy_memory_t(dense, map->dense, map->stride * map->count);
+        ac_copy_memory_t(slots, map->slots, sizeof(slot_map_slot) * map->slot_count);
+        ac_copy_memory_t(dense_slots, map->dense_slots, sizeof(u32) * map->count);
+        ac_free_t(map->dense, map_size(map->stride, map->capacity), map->tag);
+    }
+
+    map->dense = dense;
+    map->slots = slots;
+    map->dense_slots = dense_slots;
+    map->capacity = capacity;
+    return TRUE;
+}
+
+static inline slot_handle make_handle(u32 index, u32 generation)
+{
+    return ((u64)generation << 32) | index;
+}
+
+// slot of handle, or 0 if the handle is stale.
+static inline slot_map_slot* handle_slot(const slot_map* map, slot_handle handle)
+{
+    u32 index = ac_slot_handle_index_t(handle);
+    if (!map || index >= map->slot_count)
+        return 0;
+
+    slot_map_slot* slot = &map->slots[index];
+    u32 generation = ac_slot_handle_generation_t(handle);
+    return (generation != 0 && slot->generation == generation) ? slot : 0;
+}
+
+b8 ac_slot_map_create_t(u64 stride, u32 capacity, mem_tag tag, slot_map* out_map)
+{
+    if (!out_map)
+        return FALSE;
+
+    ac_zero_memory_t(out_map, sizeof(slot_map));
+    if (stride == 0)
+    {
+        ACERROR("ac_slot_map_create_t - stride must not be 0.");
+        return FALSE;
+    }
+
+    out_map->tag = tag;
+    out_map->stride = stride;
+    out_map->free_head = SLOT_MAP_NO_SLOT;
+    u32 slots = capacity > SLOT_MAP_MIN_CAPACITY ? capacity : SLOT_MAP_MIN_CAPACITY;
+    if (!map_resize(out_map, slots))
+    {
+        ACERROR("ac_slot_map_create_t - failed to allocate %u slots.", slots);
+        return FALSE;
+    }
+    return TRUE;
+}
+
+void ac_slot_map_destroy_t(slot_map* map)
+{
+    if (!map || !map->dense)
+        return;
+
+    ac_free_t(map->dense, map_size(map->stride, map->capacity), map->tag);
+    ac_zero_memory_t(map, sizeof(slot_map));
+}
+
+slot_handle ac_slot_map_insert_t(slot_map* map, const void* value)
+{
+    if (!map || !map->dense)
+        return SLOT_HANDLE_INVALID;
+
+    u32 index = map->free_head;
+    if (index != SLOT_MAP_NO_SLOT)
+    {
+        map->free_head = map->slots[index].dense_index;
+    }
+    else
+    {
+        // no free slot means every slot is live or retired, so dense is full too.
+        if (map->slot_count == map->capacity)
+        {
+            if (map->capacity > SLOT_MAP_NO_SLOT / 2)
+            {
+                ACERROR("ac_slot_map_insert_t - slot map is full.");
+                return SLOT_HANDLE_INVALID;
+            }
+            if (!map_resize(map, map->capacity * 2))
+            {
+                ACERROR("ac_slot_map_insert_t - failed to grow to %u slots.", map->capacity * 2);
+                return SLOT_HANDLE_INVALID;
+            }
+        }
+        index = map->slot_count++;
+        map->slots[index].generation = 1;
+    }
+
+    slot_map_slot* slot = &map->slots[index];
+    slot->dense_index = map->count;
+    map->dense_slots[map->count] = index;
+
+    u8* object = map->dense + map->count * map->stride;
+    if (value)
+        ac_copy_memory_small_t(object, value, map->stride);
+    else
+        ac_zero_memory_t(object, map->stride);
+    map->count++;
+
+    return make_handle(index, slot->generation);
+}
+
+void* ac_slot_map_get_t(const slot_map* map, slot_handle handle)
+{
+    slot_map_slot* slot = handle_slot(map, handle);
+    return slot ? map->dense + slot->dense_index * map->stride : 0;
+}
+
+b8 ac_slot_map_remove_t(slot_map* map, slot_handle handle, void* out_value)
+{
+    slot_map_slot* slot = handle_slot(map, handle);
+    if (!slot)
+        return FALSE;
+
+    u32 hole = slot->dense_index;
+    u8* object = map->dense + hole * map->stride;
+    if (out_value)
+        ac_copy_memory_small_t(out_value, object, map->stride);
+
+    // keep dense packed: the last object takes the hole.
+    u32 last = map->count - 1;
+    if (hole != last)
+    {
+        ac_copy_memory_small_t(object, map->dense + last * map->stride, map->stride);
+        u32 moved_slot = map->dense_slots[last];
+        map->dense_slots[hole] = moved_slot;
+        map->slots[moved_slot].dense_index = hole;
+    }
+    map->count--;
+
+    // a slot whose generation wraps is retired for good so an old handle can never match again.
+    u32 index = ac_slot_handle_index_t(handle);
+    slot->generation++;
+    if (slot->generation != 0)
+    {
+        slot->dense_index = map->free_head;
+        map->free_head = index;
+    }
+    return TRUE;
+}
+
+void ac_slot_map_clear_t(slot_map* map)
+{
+    if (!map || !map->dense)
+        return;
+
+    while (map->count > 0)
+    {
+        u32 index = map->dense_slots[map->count - 1];
+        ac_slot_map_remove_t(map, make_handle(index, map->slots[index].generation), 0);
+    }
+}
+
+slot_handle ac_slot_map_handle_at_t(const slot_map* map, u32 dense_index)
+{
+    if (!map || dense_index >= map->count)
+        return SLOT_HANDLE_INVALID;
+
+    u32 index = map->dense_slots[dense_index];
+    return make_handle(index, map->slots[index].generation);
+}
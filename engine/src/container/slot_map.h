@@ -0,0 +1,82 @@
+#pragma once
+
+#include "define.h"
+#include "core/acmemory.h"
+
+/* PERF:
+ * Slot map: objects live packed in a dense array and are referred to by a
+ * generational handle instead of a pointer. Iterating touches only live
+ * objects, back to back, and removing one moves the last object into its hole,
+ * so dense stays packed. The handle goes through the slot table, which is never
+ * compacted, so handles survive both the move and a regrow, and a handle to a
+ * removed object is caught by its generation instead of dangling.
+ * +-------------------------------------------------------------+
+ * | handle (u64):  generation (high 32)  |  slot index (low 32) |
+ * +-------------------------------------------------------------+
+ *  slots[index]     = { dense index (or next free slot), generation }
+ *  dense[i]         = object i,  dense_slots[i] = slot of object i
+ * All three arrays share one allocation, insert/remove/get are O(1).
+ */
+
+typedef u64 slot_handle;
+
+// Never returned by insert, safe to use as "no object".
+#define SLOT_HANDLE_INVALID 0
+
+#define SLOT_MAP_MIN_CAPACITY 16
+
+#define ac_slot_handle_index_t(handle) ((u32)((handle) & 0xFFFFFFFFu))
+#define ac_slot_handle_generation_t(handle) ((u32)((handle) >> 32))
+
+typedef struct slot_map_slot
+{
+    u32 dense_index; // next free slot while the slot is free.
+    u32 generation;  // bumped on remove, 0 means the slot is retired.
+} slot_map_slot;
+
+typedef struct slot_map
+{
+    mem_tag tag;
+    u64 stride;
+    u32 count;      // live objects, dense[0..count).
+    u32 capacity;   // objects and slots the arrays can hold.
+    u32 slot_count; // slots handed out so far.
+    u32 free_head;
+
+    u8* dense;
+    u32* dense_slots;
+    slot_map_slot* slots;
+} slot_map;
+
+/* INFO:
+ * Creates a slot map.
+ * stride: Size in bytes of an object.
+ * capacity: Expected number of objects, the map grows past it when needed.
+ * tag: Memory tag the arrays are accounted under.
+ *
+ * WARN: Growing moves dense, pointers from get are valid until the next insert or remove.
+ *       Keep the handle, not the pointer.
+ */
+ACAPI b8 ac_slot_map_create_t(u64 stride, u32 capacity, mem_tag tag, slot_map* out_map);
+ACAPI void ac_slot_map_destroy_t(slot_map* map);
+
+// Copies value in (0 leaves the object zeroed).
+// Returns: Handle of the new object, SLOT_HANDLE_INVALID if the map could not grow.
+ACAPI slot_handle ac_slot_map_insert_t(slot_map* map, const void* value);
+
+// Returns: The object of handle, or 0 if it was removed (or never existed).
+ACAPI void* ac_slot_map_get_t(const slot_map* map, slot_handle handle);
+
+// Removes the object, copying it to out_value when given. Returns FALSE for a stale handle.
+ACAPI b8 ac_slot_map_remove_t(slot_map* map, slot_handle handle, void* out_value);
+
+// Removes every object, every handle handed out so far becomes stale.
+ACAPI void ac_slot_map_clear_t(slot_map* map);
+
+// Returns: Handle of dense[dense_index], to go from iteration back to a handle.
+ACAPI slot_handle ac_slot_map_handle_at_t(const slot_map* map, u32 dense_index);
+
+#define ac_slot_map_create_type_t(type, capacity, tag, out_map) ac_slot_map_create_t(sizeof(type), capacity, tag, out_map)
+
+// Iterates the live objects in dense order: ac_slot_map_data_t(map, type)[0 .. map->count).
+#define ac_slot_map_data_t(map, type) ((type*)(map)->dense)
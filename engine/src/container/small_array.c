@@ -0,0 +1,95 @@
+#include "container/small_array.h"
+#include "core/acmemory.h"
+#include "core/logger.h"
+
+static u8* small_array_data(small_array_header* header, void* inline_data)
+{
+    return header->heap ? (u8*)header->heap : (u8*)inline_data;
+}
+
+// moves the elements into a heap block of capacity, freeing the previous heap block if any.
+// on failure the array keeps its old storage.
+static b8 small_array_spill(small_array_header* header, void* inline_data, u64 stride, u64 capacity)
+{
+    // every element is copied over, no need to zero.
+    void* block = ac_allocate_uninit_t(capacity * stride, MEMTAG_ARRAY);
+    if (!block)
+    {
+        ACERROR("small_array - failed to grow to %llu elements.", capacity);
+        return FALSE;
+    }
+    ac_copy_memory_t(block, small_array_data(header, inline_data), header->length * stride);
+
+    if (header->heap)
+        ac_free_t(header->heap, header->capacity * stride, MEMTAG_ARRAY);
+    header->heap = block;
+    header->capacity = (u32)capacity;
+    return TRUE;
+}
+
+b8 _small_array_push(small_array_header* header, void* inline_data, u64 inline_count, u64 stride, const void* value_ptr)
+{
+    u64 capacity = header->heap ? header->capacity : inline_count;
+    if (header->length >= capacity && !small_array_spill(header, inline_data, stride, capacity * 2))
+        return FALSE;
+
+    u8* data = small_array_data(header, inline_data);
+    ac_copy_memory_small_t(data + header->length * stride, value_ptr, stride);
+    header->length++;
+    return TRUE;
+}
+
+b8 _small_array_reserve(small_array_header* header, void* inline_data, u64 inline_count, u64 stride, u64 capacity)
+{
+    u64 current = header->heap ? header->capacity : inline_count;
+    if (capacity <= current)
+        return TRUE;
+
+    return small_array_spill(header, inline_data, stride, capacity);
+}
+
+void _small_array_pop_at(small_array_header* header, void* inline_data, u64 stride, u64 index, void* dest)
+{
+    u64 length = header->length;
+    if (index >= length)
+    {
+        ACERROR("Index outside of bounds! Length: %llu, index: %llu", length, index);
+        return;
+    }
+
+    u8* element = small_array_data(header, inline_data) + index * stride;
+    if (dest)
+        ac_copy_memory_small_t(dest, element, stride);
+
+    // close the gap, the ranges overlap.
+    ac_move_memory_t(element, element + stride, stride * (length - index - 1));
+    header->length--;
+}
+
+void _small_array_swap_remove(small_array_header* header, void* inline_data, u64 stride, u64 index, void* dest)
+{
+    u64 length = header->length;
+    if (index >= length)
+    {
+        ACERROR("Index outside of bounds! Length: %llu, index: %llu", length, index);
+        return;
+    }
+
+    u8* data = small_array_data(header, inline_data);
+    u8* element = data + index * stride;
+    if (dest)
+        ac_copy_memory_small_t(dest, element, stride);
+
+    if (index != length - 1)
+        ac_copy_memory_small_t(element, data + (length - 1) * stride, stride);
+    header->length--;
+}
+
+void _small_array_destroy(small_array_header* header, u64 stride)
+{
+    if (header->heap)
+        ac_free_t(header->heap, header->capacity * stride, MEMTAG_ARRAY);
+    header->heap = 0;
+    header->length = 0;
+    header->capacity = 0;
+}
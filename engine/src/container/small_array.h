@@ -0,0 +1,83 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Array that keeps its first inline_count elements inside the struct and only
+ * allocates once it outgrows them. Meant for short lists that almost always
+ * stay tiny (extension names, listeners of one event code), where a dyn_array
+ * would pay a header + payload allocation for two or three elements.
+ * +------------------------------------------+--------------------------------+
+ * | small_array_header                       | inline_data[inline_count]      |
+ * +------------------------------------------+--------------------------------+
+ * | heap (0 while inline) | length | capacity| used until length > inline_count|
+ * +------------------------------------------+--------------------------------+
+ * Once spilled every element lives on the heap (MEMTAG_ARRAY) and the inline
+ * slots are unused, so the data pointer is always one contiguous block.
+ * A zeroed struct is a valid empty array, no create call is needed.
+ */
+
+typedef struct small_array_header
+{
+    void* heap;
+    u32 length;
+    u32 capacity; // heap capacity, only valid while heap != 0.
+} small_array_header;
+
+// declares the struct type, e.g. typedef SMALL_ARRAY(const char*, 8) name_array;
+#define SMALL_ARRAY(type, inline_count)                                                                                                    \
+    struct                                                                                                                                 \
+    {                                                                                                                                      \
+        small_array_header header;                                                                                                         \
+        type inline_data[inline_count];                                                                                                    \
+    }
+
+ACAPI b8 _small_array_push(small_array_header* header, void* inline_data, u64 inline_count, u64 stride, const void* value_ptr);
+ACAPI b8 _small_array_reserve(small_array_header* header, void* inline_data, u64 inline_count, u64 stride, u64 capacity);
+ACAPI void _small_array_pop_at(small_array_header* header, void* inline_data, u64 stride, u64 index, void* dest);
+ACAPI void _small_array_swap_remove(small_array_header* header, void* inline_data, u64 stride, u64 index, void* dest);
+ACAPI void _small_array_destroy(small_array_header* header, u64 stride);
+
+#define SMALL_ARRAY_INLINE_COUNT(array) (sizeof((array)->inline_data) / sizeof((array)->inline_data[0]))
+#define SMALL_ARRAY_STRIDE(array) sizeof((array)->inline_data[0])
+
+#define ac_small_array_init_t(array) ((array)->header = (small_array_header){ 0 })
+
+// frees the heap block if the array spilled and leaves it empty and inline.
+#define ac_small_array_destroy_t(array) _small_array_destroy(&(array)->header, SMALL_ARRAY_STRIDE(array))
+
+#define ac_small_array_data_t(array)                                                                                                       \
+    ((array)->header.heap ? (__typeof__(&(array)->inline_data[0]))(array)->header.heap : (array)->inline_data)
+
+#define ac_small_array_length_t(array) ((u64)(array)->header.length)
+
+#define ac_small_array_capacity_t(array) ((array)->header.heap ? (u64)(array)->header.capacity : SMALL_ARRAY_INLINE_COUNT(array))
+
+#define ac_small_array_spilled_t(array) ((array)->header.heap != 0)
+
+#define ac_small_array_push_t(array, value)                                                                                                \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        __typeof__((array)->inline_data[0]) _small_array_temp = value;                                                                     \
+        _small_array_push(&(array)->header, (array)->inline_data, SMALL_ARRAY_INLINE_COUNT(array), SMALL_ARRAY_STRIDE(array),              \
+                          &_small_array_temp);                                                                                             \
+    } while (0)
+
+// same as push but takes a pointer to the value. Returns FALSE if the array could not grow, it is left unchanged.
+#define ac_small_array_push_ptr_t(array, value_ptr)                                                                                        \
+    _small_array_push(&(array)->header, (array)->inline_data, SMALL_ARRAY_INLINE_COUNT(array), SMALL_ARRAY_STRIDE(array), value_ptr)
+
+// spills right away when capacity does not fit inline, never shrinks. FALSE if the allocation failed.
+#define ac_small_array_reserve_t(array, capacity)                                                                                          \
+    _small_array_reserve(&(array)->header, (array)->inline_data, SMALL_ARRAY_INLINE_COUNT(array), SMALL_ARRAY_STRIDE(array), capacity)
+
+// removes index keeping the order. value_ptr can be 0.
+#define ac_small_array_pop_at_t(array, index, value_ptr)                                                                                   \
+    _small_array_pop_at(&(array)->header, (array)->inline_data, SMALL_ARRAY_STRIDE(array), index, value_ptr)
+
+// removes index by moving the last element into it, does not keep the order. value_ptr can be 0.
+#define ac_small_array_swap_remove_t(array, index, value_ptr)                                                                              \
+    _small_array_swap_remove(&(array)->header, (array)->inline_data, SMALL_ARRAY_STRIDE(array), index, value_ptr)
+
+// keeps the heap block if there is one.
+#define ac_small_array_clear_t(array) ((array)->header.length = 0)
@@ -0,0 +1,99 @@
+#include "container/sparse_set.h"
+
+#include "core/acmemory.h"
+
+static u32* grow_array(u32* array, u32 old_capacity, u32 new_capacity)
+{
+    u32* grown = ac_allocate_uninit_t(new_capacity * sizeof(u32), MEMTAG_ARRAY);
+    if (array)
+    {
+        ac_copy_memory_t(grown, array, old_capacity * sizeof(u32));
+        ac_free_t(array, old_capacity * sizeof(u32), MEMTAG_ARRAY);
+    }
+    // not needed for correctness, keeps sanitizers quiet about reading stale entries.
+    ac_set_memory_t(grown + old_capacity, 0xFF, (new_capacity - old_capacity) * sizeof(u32));
+    return grown;
+}
+
+static u32 grown_capacity(u32 capacity, u32 needed)
+{
+    u32 grown = capacity ? capacity : 16;
+    while (grown < needed)
+        grown = grown > 0x7FFFFFFFu ? 0xFFFFFFFFu : grown * 2;
+    return grown;
+}
+
+void ac_sparse_set_create_t(u32 max_id, u32 capacity, sparse_set* out_set)
+{
+    if (!out_set)
+        return;
+
+    ac_zero_memory_t(out_set, sizeof(sparse_set));
+    if (max_id)
+    {
+        out_set->sparse = grow_array(0, 0, max_id);
+        out_set->sparse_capacity = max_id;
+    }
+    if (capacity)
+    {
+        out_set->dense = grow_array(0, 0, capacity);
+        out_set->dense_capacity = capacity;
+    }
+}
+
+void ac_sparse_set_destroy_t(sparse_set* set)
+{
+    if (!set)
+        return;
+
+    if (set->sparse)
+        ac_free_t(set->sparse, set->sparse_capacity * sizeof(u32), MEMTAG_ARRAY);
+    if (set->dense)
+        ac_free_t(set->dense, set->dense_capacity * sizeof(u32), MEMTAG_ARRAY);
+    ac_zero_memory_t(set, sizeof(sparse_set));
+}
+
+u32 ac_sparse_set_insert_t(sparse_set* set, u32 id)
+{
+    if (!set || id == SPARSE_SET_NONE)
+        return SPARSE_SET_NONE;
+
+    if (ac_sparse_set_contains_t(set, id))
+        return set->sparse[id];
+
+    if (id >= set->sparse_capacity)
+    {
+        u32 capacity = grown_capacity(set->sparse_capacity, id + 1);
+        set->sparse = grow_array(set->sparse, set->sparse_capacity, capacity);
+        set->sparse_capacity = capacity;
+    }
+    if (set->count == set->dense_capacity)
+    {
+        u32 capacity = grown_capacity(set->dense_capacity, set->count + 1);
+        set->dense = grow_array(set->dense, set->dense_capacity, capacity);
+        set->dense_capacity = capacity;
+    }
+
+    u32 index = set->count++;
+    set->dense[index] = id;
+    set->sparse[id] = index;
+    return index;
+}
+
+u32 ac_sparse_set_remove_t(sparse_set* set, u32 id)
+{
+    if (!set || !ac_sparse_set_contains_t(set, id))
+        return SPARSE_SET_NONE;
+
+    u32 index = set->sparse[id];
+    u32 last = set->dense[--set->count];
+    set->dense[index] = last;
+    set->sparse[last] = index;
+    return index;
+}
+
+void ac_sparse_set_clear_t(sparse_set* set)
+{
+    if (set)
+        set->count = 0;
+}
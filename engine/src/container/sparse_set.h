@@ -0,0 +1,59 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Set of u32 ids (entity ids, slot indices) with O(1) insert/remove/contains
+ * and a packed dense list of the members for iteration. sparse is indexed by
+ * id and points into dense, dense points back, an id is a member only if both
+ * agree, so neither array ever needs clearing and clear is O(1).
+ * +------------------------------+     +-----------------------+
+ * | sparse[id] -> dense index    | <-> | dense[i] -> id        |
+ * +------------------------------+     +-----------------------+
+ * |  one u32 per possible id     |     |  count members, packed|
+ * +------------------------------+     +-----------------------+
+ * Component data can live in arrays parallel to dense, remove moves the last
+ * member into the hole so those arrays must do the same move.
+ */
+
+#define SPARSE_SET_NONE 0xFFFFFFFFu
+
+typedef struct sparse_set
+{
+    u32* sparse;
+    u32* dense;
+    u32 count;
+    u32 dense_capacity;
+    u32 sparse_capacity; // ids [0, sparse_capacity) can be stored without growing.
+} sparse_set;
+
+/* INFO:
+ * Creates an empty sparse set.
+ * max_id: Expected largest id + 1, the sparse array grows past it when needed.
+ * capacity: Expected number of members, dense grows past it when needed.
+ */
+ACAPI void ac_sparse_set_create_t(u32 max_id, u32 capacity, sparse_set* out_set);
+ACAPI void ac_sparse_set_destroy_t(sparse_set* set);
+
+// Returns: Dense index of id (new or already present).
+ACAPI u32 ac_sparse_set_insert_t(sparse_set* set, u32 id);
+
+/* INFO:
+ * Removes id. dense[count - 1] is moved into the returned index, do the same
+ * move in arrays kept parallel to dense.
+ * Returns: Dense index id had, or SPARSE_SET_NONE if id was not a member.
+ */
+ACAPI u32 ac_sparse_set_remove_t(sparse_set* set, u32 id);
+
+ACAPI void ac_sparse_set_clear_t(sparse_set* set);
+
+static inline b8 ac_sparse_set_contains_t(const sparse_set* set, u32 id)
+{
+    return id < set->sparse_capacity && set->sparse[id] < set->count && set->dense[set->sparse[id]] == id;
+}
+
+// Returns: Dense index of id, or SPARSE_SET_NONE.
+static inline u32 ac_sparse_set_index_t(const sparse_set* set, u32 id)
+{
+    return ac_sparse_set_contains_t(set, id) ? set->sparse[id] : SPARSE_SET_NONE;
+}
@@ -1,56 +1,718 @@
 #include "acmemory.h"
 
-#include "core/astring.h"
+#include "core/event.h"
 #include "core/logger.h"
+#include "core/string_builder.h"
+#include "memory/alloc_tracker.h"
+#include "memory/freelist_alloc.h"
+#include "memory/linear_alloc.h"
 #include "platform/platform.h"
 
-#include <stdio.h>
-#include <string.h>
 
-struct mem_stats
+// the tracking macros from acmemory.h would rename the definitions below.
+#undef ac_allocate_t
+#undef ac_allocate_uninit_t
+#undef ac_allocate_aligned_t
+#undef ac_allocate_large_t
+
+/* PERF:
+ * Every thread that allocates claims its own cache line aligned counter slot
+ * and only ever writes to that slot, so the hot path has no lock and no shared
+ * cache line. Counters are monotonic (allocation/free counts, alignment padding).
+ * Threads past MAX_MEMORY_THREADS share the overflow slot using atomic adds.
+ * Current usage and its high-water mark are kept apart, one cache line per tag
+ * plus one for the total: an atomic add on every allocate/free, the peak is only
+ * written (CAS) when the add returns a new maximum. That way a spike between
+ * two reads is still recorded, and a block allocated on one slot and freed on
+ * another can never be seen half way.
+ */
+#define MAX_MEMORY_THREADS 64
+
+typedef struct ACALIGN(ACCACHE_LINE_SIZE) mem_thread_stats
 {
-    u64 total_allocated;
-    u64 tagged_allocation[MEMTAG_MAX_TAGS];
-};
+    u64 alloc_count[MEMTAG_MAX_TAGS];
+    u64 free_count[MEMTAG_MAX_TAGS];
+
+    // worst case bytes the platform may spend to align aligned allocations.
+    u64 padding_added;
+    u64 padding_removed;
+
+    b8 shared;
+} mem_thread_stats;
 
 static const char* memtag_string[MEMTAG_MAX_TAGS] = { "UNKNOWN", "ARRAY",       "DYN_ARRAY", "DICT",        "RING_QUEUE", "BST",
                                                       "STRING",  "APPLICATION", "JOB",    "TEXTURE",     "MAT_INST",   "RENDERER",
-                                                      "GAME",    "TRANSFORM",   "ENTITY", "ENTITY_NODE", "SCENE" };
+                                                      "GAME",    "TRANSFORM",   "ENTITY", "ENTITY_NODE", "SCENE",
+                                                      "LINEAR_ALLOC", "VK_COMMAND", "VK_OBJECT", "VK_CACHE", "VK_DEVICE",
+                                                      "VK_INSTANCE" };
+
+static mem_thread_stats thread_stats[MAX_MEMORY_THREADS];
+static mem_thread_stats overflow_stats = { .shared = TRUE };
+static u32 thread_stats_count = 0;
+static ACTHREAD_LOCAL mem_thread_stats* local_stats = 0;
 
-static struct mem_stats stats;
+typedef struct ACALIGN(ACCACHE_LINE_SIZE) mem_usage
+{
+    u64 current; // bytes
+    u64 peak;    // bytes
+} mem_usage;
+
+static mem_usage usage_tagged[MEMTAG_MAX_TAGS];
+static mem_usage usage_total;
+
+// registered from any thread (per-thread stack allocators), guarded by linear_allocs_lock.
+static linear_alloc* linear_allocs[MAX_TRACKED_LINEAR_ALLOC];
+static b8 linear_allocs_lock;
+
+static void registry_lock()
+{
+    while (__atomic_test_and_set(&linear_allocs_lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
 
-void memory_initialize()
+static void registry_unlock()
 {
-    platform_zero_mem(&stats, sizeof(stats));
+    __atomic_clear(&linear_allocs_lock, __ATOMIC_RELEASE);
 }
 
-void memory_shutdown() {}
+/* INFO:
+ * Blocks mapped with platform_allocate_large. Few and big, a small locked
+ * table is enough to remember which page kind each one got.
+ */
+#define MAX_LARGE_BLOCKS 256
 
-void* ac_allocate_t(u64 size, mem_tag tag)
+typedef struct large_block
+{
+    void* block;
+    u64 size;
+    platform_page_kind kind;
+} large_block;
+
+static large_block large_blocks[MAX_LARGE_BLOCKS];
+static u64 large_bytes[PLATFORM_PAGE_KIND_MAX];
+static u32 large_block_count;
+static b8 large_lock;
+
+static void large_blocks_lock()
+{
+    while (__atomic_test_and_set(&large_lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void large_blocks_unlock()
+{
+    __atomic_clear(&large_lock, __ATOMIC_RELEASE);
+}
+
+static u64 large_size(u64 size)
+{
+    return (size + PLATFORM_LARGE_PAGE_SIZE - 1) & ~((u64)PLATFORM_LARGE_PAGE_SIZE - 1);
+}
+
+// maps and remembers a large block. Returns 0 when mapping fails or the table is full.
+static void* large_map(u64 size)
+{
+    platform_page_kind kind;
+    void* block = platform_allocate_large(size, &kind);
+    if (!block)
+        return 0;
+
+    large_blocks_lock();
+    for (u32 i = 0; i < MAX_LARGE_BLOCKS; ++i)
+    {
+        if (large_blocks[i].block == 0)
+        {
+            large_blocks[i].block = block;
+            large_blocks[i].size = size;
+            large_blocks[i].kind = kind;
+            large_bytes[kind] += large_size(size);
+            large_block_count++;
+            large_blocks_unlock();
+            return block;
+        }
+    }
+    large_blocks_unlock();
+
+    ACERROR("Too many large blocks (%u), refusing %lluB.", MAX_LARGE_BLOCKS, size);
+    platform_free_large(block, size);
+    return 0;
+}
+
+static b8 large_is_mapped(void* block)
+{
+    b8 found = FALSE;
+    large_blocks_lock();
+    for (u32 i = 0; i < MAX_LARGE_BLOCKS && !found; ++i)
+        found = large_blocks[i].block == block;
+    large_blocks_unlock();
+    return found;
+}
+
+// returns FALSE when block was not mapped by large_map.
+static b8 large_unmap(void* block)
+{
+    large_blocks_lock();
+    for (u32 i = 0; i < MAX_LARGE_BLOCKS; ++i)
+    {
+        if (large_blocks[i].block == block)
+        {
+            u64 size = large_blocks[i].size;
+            large_bytes[large_blocks[i].kind] -= large_size(size);
+            large_block_count--;
+            large_blocks[i].block = 0;
+            large_blocks_unlock();
+
+            platform_free_large(block, size);
+            return TRUE;
+        }
+    }
+    large_blocks_unlock();
+    return FALSE;
+}
+
+/* PERF:
+ * Engine heap. One block of ACMEMORY_HEAP_BUDGET bytes claimed at startup, ac_allocate_* carve
+ * blocks out of it so the hot path never reaches malloc. A spinlock guards it, the critical
+ * section is a free list walk. Once it is full allocations fall back to the platform allocator,
+ * frees tell the two apart by address.
+ */
+typedef struct memory_heap
+{
+    freelist_alloc alloc;
+    u64 fallback_count;
+    b8 exhausted; // warned already, re-armed once usage drops back under 3/4 of the budget.
+    b8 lock;
+} memory_heap;
+
+static memory_heap heap;
+
+static void heap_lock()
+{
+    while (__atomic_test_and_set(&heap.lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void heap_unlock()
+{
+    __atomic_clear(&heap.lock, __ATOMIC_RELEASE);
+}
+
+static void heap_initialize(u64 budget)
+{
+    platform_zero_mem(&heap, sizeof(heap));
+    if (budget == 0)
+        return;
+
+    // one big long lived block, the best candidate for huge pages.
+    u64 size = large_size(budget);
+    void* memory = large_map(size);
+    if (!memory)
+    {
+        ACERROR("Could not claim the %lluB engine heap, using the platform allocator.", size);
+        return;
+    }
+
+    if (!ac_freelist_alloc_create_t("engine heap", size, memory, &heap.alloc))
+        large_unmap(memory);
+}
+
+static void heap_shutdown()
+{
+    if (!heap.alloc.memory)
+        return;
+
+    void* memory = heap.alloc.memory;
+    ac_freelist_alloc_destroy_t(&heap.alloc);
+    large_unmap(memory);
+}
+
+// returns 0 when the heap is not used or full, the caller falls back to the platform.
+static void* heap_allocate(u64 size, u16 alignment)
+{
+    if (!heap.alloc.memory)
+        return 0;
+
+    heap_lock();
+    void* block = ac_freelist_alloc_allocate_t(&heap.alloc, size, alignment);
+    b8 warn = FALSE;
+    if (!block)
+    {
+        warn = !heap.exhausted;
+        heap.exhausted = TRUE;
+        heap.fallback_count++;
+    }
+    heap_unlock();
+
+    if (warn)
+        ACWARN("Engine heap budget (%lluB) exhausted, falling back to the platform allocator.", heap.alloc.total_size);
+
+    return block;
+}
+
+// returns FALSE when block does not come from the heap.
+static b8 heap_free(void* block)
+{
+    if (!ac_freelist_alloc_owns_t(&heap.alloc, block))
+        return FALSE;
+
+    heap_lock();
+    ac_freelist_alloc_free_t(&heap.alloc, block);
+    if (heap.exhausted && heap.alloc.allocated < heap.alloc.total_size / 4 * 3)
+        heap.exhausted = FALSE;
+    heap_unlock();
+    return TRUE;
+}
+
+/* PERF:
+ * Per-tag budgets. Only tags with a budget keep a shared running total, the
+ * other tags stay on the lock free per-thread counters above. The hard limit
+ * is enforced by adding first and backing out when the limit was crossed, so
+ * concurrent allocations can never push the total past it.
+ * Level changes are only latched here, memory_update fires EVENT_CODE_MEMORY_BUDGET
+ * later from the main thread, listeners never run inside an allocation.
+ */
+typedef struct memory_budget
+{
+    b8 enabled;
+    u64 soft_limit;
+    u64 hard_limit;
+    u64 current;
+    u32 level;       // memory_budget_level, latched by the allocating threads.
+    u32 changes;     // bumped on every level change.
+    u32 dispatched;  // changes seen by the last memory_update.
+} memory_budget;
+
+static memory_budget budgets[MEMTAG_MAX_TAGS];
+
+static void budget_set_level(mem_tag tag, memory_budget_level level, u64 current)
+{
+    memory_budget* budget = &budgets[tag];
+    u32 previous = __atomic_exchange_n(&budget->level, level, __ATOMIC_RELAXED);
+    if (previous == (u32)level)
+        return;
+
+    if (level == MEMORY_BUDGET_SOFT && previous == MEMORY_BUDGET_OK)
+        ACWARN("Memory tag %s crossed its soft budget: %lluB of %lluB.", memtag_string[tag], current, budget->soft_limit);
+
+    // picked up by memory_update.
+    __atomic_fetch_add(&budget->changes, 1, __ATOMIC_RELEASE);
+}
+
+// returns FALSE when the allocation would cross the tag's hard limit.
+static b8 budget_charge(u64 size, mem_tag tag, b8 enforce)
+{
+    memory_budget* budget = &budgets[tag];
+    if (!__atomic_load_n(&budget->enabled, __ATOMIC_RELAXED))
+        return TRUE;
+
+    u64 current = __atomic_add_fetch(&budget->current, size, __ATOMIC_RELAXED);
+    if (enforce && budget->hard_limit && current > budget->hard_limit)
+    {
+        current = __atomic_sub_fetch(&budget->current, size, __ATOMIC_RELAXED);
+        ACERROR("Memory tag %s refused %lluB, it would cross the hard budget (%lluB of %lluB in use).",
+                memtag_string[tag],
+                size,
+                current,
+                budget->hard_limit);
+        budget_set_level(tag, MEMORY_BUDGET_HARD, current);
+        return FALSE;
+    }
+
+    if (budget->soft_limit && current >= budget->soft_limit &&
+        __atomic_load_n(&budget->level, __ATOMIC_RELAXED) == MEMORY_BUDGET_OK)
+        budget_set_level(tag, MEMORY_BUDGET_SOFT, current);
+
+    return TRUE;
+}
+
+static void budget_release(u64 size, mem_tag tag)
+{
+    memory_budget* budget = &budgets[tag];
+    if (!__atomic_load_n(&budget->enabled, __ATOMIC_RELAXED))
+        return;
+
+    u64 current = __atomic_sub_fetch(&budget->current, size, __ATOMIC_RELAXED);
+    u32 level = __atomic_load_n(&budget->level, __ATOMIC_RELAXED);
+    if (level == MEMORY_BUDGET_OK)
+        return;
+
+    // a freed block re-arms the hard limit event, dropping under the soft limit clears the pressure.
+    if (!budget->soft_limit || current < budget->soft_limit)
+        budget_set_level(tag, MEMORY_BUDGET_OK, current);
+    else if (level == MEMORY_BUDGET_HARD)
+        budget_set_level(tag, MEMORY_BUDGET_SOFT, current);
+}
+
+static mem_thread_stats* get_thread_stats()
+{
+    if (local_stats)
+        return local_stats;
+
+    u32 index = __atomic_fetch_add(&thread_stats_count, 1, __ATOMIC_RELAXED);
+    if (index < MAX_MEMORY_THREADS)
+    {
+        local_stats = &thread_stats[index];
+    }
+    else
+    {
+        local_stats = &overflow_stats;
+    }
+    return local_stats;
+}
+
+static inline void stat_add(mem_thread_stats* slot, u64* counter, u64 value)
+{
+    // owner thread is the only writer, a plain load/store is enough.
+    if (slot->shared)
+        __atomic_fetch_add(counter, value, __ATOMIC_RELAXED);
+    else
+        __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + value, __ATOMIC_RELAXED);
+}
+
+static void raise_peak(u64* peak, u64 value)
+{
+    u64 current = __atomic_load_n(peak, __ATOMIC_RELAXED);
+    while (value > current && !__atomic_compare_exchange_n(peak, &current, value, TRUE, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+    {
+    }
+}
+
+static void usage_add(mem_usage* usage, u64 size)
+{
+    raise_peak(&usage->peak, __atomic_add_fetch(&usage->current, size, __ATOMIC_RELAXED));
+}
+
+static void record_allocate(u64 size, mem_tag tag, u64 padding)
+{
+    usage_add(&usage_tagged[tag], size);
+    usage_add(&usage_total, size);
+
+    mem_thread_stats* slot = get_thread_stats();
+    stat_add(slot, &slot->alloc_count[tag], 1);
+    if (padding)
+        stat_add(slot, &slot->padding_added, padding);
+}
+
+static void record_free(u64 size, mem_tag tag, u64 padding)
+{
+    __atomic_sub_fetch(&usage_tagged[tag].current, size, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&usage_total.current, size, __ATOMIC_RELAXED);
+
+    mem_thread_stats* slot = get_thread_stats();
+    stat_add(slot, &slot->free_count[tag], 1);
+    if (padding)
+        stat_add(slot, &slot->padding_removed, padding);
+}
+
+static void collect_stats(memory_stats* out)
+{
+    platform_zero_mem(out, sizeof(memory_stats));
+
+    u64 padding_added = 0;
+    u64 padding_removed = 0;
+
+    u32 slot_count = __atomic_load_n(&thread_stats_count, __ATOMIC_RELAXED);
+    slot_count = slot_count < MAX_MEMORY_THREADS ? slot_count : MAX_MEMORY_THREADS;
+    for (u32 s = 0; s <= slot_count; ++s)
+    {
+        mem_thread_stats* slot = s < slot_count ? &thread_stats[s] : &overflow_stats;
+        for (u32 i = 0; i < MEMTAG_MAX_TAGS; ++i)
+        {
+            out->tags[i].alloc_count += __atomic_load_n(&slot->alloc_count[i], __ATOMIC_RELAXED);
+            out->tags[i].free_count += __atomic_load_n(&slot->free_count[i], __ATOMIC_RELAXED);
+        }
+        padding_added += __atomic_load_n(&slot->padding_added, __ATOMIC_RELAXED);
+        padding_removed += __atomic_load_n(&slot->padding_removed, __ATOMIC_RELAXED);
+    }
+
+    for (u32 i = 0; i < MEMTAG_MAX_TAGS; ++i)
+    {
+        out->tags[i].current = __atomic_load_n(&usage_tagged[i].current, __ATOMIC_RELAXED);
+        out->tags[i].peak = __atomic_load_n(&usage_tagged[i].peak, __ATOMIC_RELAXED);
+        if (__atomic_load_n(&budgets[i].enabled, __ATOMIC_RELAXED))
+        {
+            out->tags[i].soft_limit = budgets[i].soft_limit;
+            out->tags[i].hard_limit = budgets[i].hard_limit;
+        }
+    }
+    out->alignment_padding = padding_added > padding_removed ? padding_added - padding_removed : 0;
+    out->total_allocated = __atomic_load_n(&usage_total.current, __ATOMIC_RELAXED);
+    out->total_peak = __atomic_load_n(&usage_total.peak, __ATOMIC_RELAXED);
+
+    if (heap.alloc.memory)
+    {
+        freelist_alloc_stats heap_stats;
+        heap_lock();
+        ac_freelist_alloc_get_stats_t(&heap.alloc, &heap_stats);
+        out->heap.budget = heap.alloc.total_size;
+        out->heap.used = heap.alloc.allocated;
+        out->heap.fallback_count = heap.fallback_count;
+        heap_unlock();
+        out->heap.largest_free_block = heap_stats.largest_free_block;
+        out->heap.free_block_count = heap_stats.free_block_count;
+        out->heap.fragmentation = heap_stats.fragmentation;
+    }
+
+    large_blocks_lock();
+    out->large_pages.huge = large_bytes[PLATFORM_PAGE_HUGE];
+    out->large_pages.transparent_huge = large_bytes[PLATFORM_PAGE_TRANSPARENT_HUGE];
+    out->large_pages.normal = large_bytes[PLATFORM_PAGE_NORMAL];
+    out->large_pages.block_count = large_block_count;
+    large_blocks_unlock();
+
+    registry_lock();
+    for (u32 i = 0; i < MAX_TRACKED_LINEAR_ALLOC; ++i)
+    {
+        linear_alloc* alloc = linear_allocs[i];
+        if (alloc == 0)
+            continue;
+
+        // NOTE: allocators owned by other threads keep running, their numbers are a snapshot.
+        memory_linear_alloc_stats* entry = &out->linear_allocs[out->linear_alloc_count++];
+        entry->name = alloc->name;
+        entry->used = __atomic_load_n(&alloc->allocated, __ATOMIC_RELAXED);
+        entry->high_water = __atomic_load_n(&alloc->high_water, __ATOMIC_RELAXED);
+        entry->total_size = alloc->total_size;
+    }
+    registry_unlock();
+}
+
+void memory_initialize(u64 heap_budget)
+{
+    // slot assignment (thread_stats_count) is kept, threads may already own one.
+    platform_zero_mem(thread_stats, sizeof(thread_stats));
+    platform_zero_mem(&overflow_stats, sizeof(overflow_stats));
+    overflow_stats.shared = TRUE;
+    platform_zero_mem(usage_tagged, sizeof(usage_tagged));
+    platform_zero_mem(&usage_total, sizeof(usage_total));
+    platform_zero_mem(linear_allocs, sizeof(linear_allocs));
+    platform_zero_mem(budgets, sizeof(budgets));
+
+    alloc_tracker_initialize();
+    heap_initialize(heap_budget);
+}
+
+void memory_update()
+{
+    for (u32 i = 0; i < MEMTAG_MAX_TAGS; ++i)
+    {
+        memory_budget* budget = &budgets[i];
+        if (!__atomic_load_n(&budget->enabled, __ATOMIC_ACQUIRE))
+            continue;
+
+        u32 changes = __atomic_load_n(&budget->changes, __ATOMIC_ACQUIRE);
+        if (changes == budget->dispatched)
+            continue;
+        budget->dispatched = changes;
+
+        // several changes since the last update fire once, with the level the tag is at now.
+        event_context context = {};
+        context.data.u32[0] = i;
+        context.data.u32[1] = __atomic_load_n(&budget->level, __ATOMIC_RELAXED);
+        context.data.u64[1] = __atomic_load_n(&budget->current, __ATOMIC_RELAXED);
+        ac_event_fire_t(EVENT_CODE_MEMORY_BUDGET, 0, context);
+    }
+}
+
+void memory_shutdown()
+{
+    alloc_tracker_shutdown();
+    heap_shutdown();
+}
+
+static void* allocate_block(u64 size, mem_tag tag, b8 zeroed)
 {
     if (tag == MEMTAG_UNKNOWN)
         ACWARN("ac_allocated called using MEMTAG_UNKNOWN, Re-Class this allocation");
 
-    stats.total_allocated += size;
-    stats.tagged_allocation[tag] += size;
+    if (!budget_charge(size, tag, TRUE))
+        return 0;
+
+    void* block = heap_allocate(size, PLATFORM_MALLOC_ALIGNMENT);
+    if (!block)
+        block = platform_allocated(size, FALSE);
+    if (!block)
+    {
+        ACERROR("ac_allocate_t - failed to allocate %lluB.", size);
+        budget_release(size, tag);
+        return 0;
+    }
+    if (zeroed)
+        platform_zero_mem(block, size);
+
+    record_allocate(size, tag, 0);
+
+    return block;
+}
 
-    // TODO : set memory allignment
-    void* block = platform_allocated(size, FALSE);
+static u64 alignment_padding(u16 alignment)
+{
+    return alignment > PLATFORM_MALLOC_ALIGNMENT ? alignment - PLATFORM_MALLOC_ALIGNMENT : 0;
+}
+
+static void* allocate_aligned_block(u64 size, u16 alignment, mem_tag tag)
+{
+    if (tag == MEMTAG_UNKNOWN)
+        ACWARN("ac_allocate_aligned_t called using MEMTAG_UNKNOWN, Re-Class this allocation");
+
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        ACERROR("ac_allocate_aligned_t - alignment %u is not a power of two.", alignment);
+        return 0;
+    }
+
+    if (!budget_charge(size, tag, TRUE))
+        return 0;
+
+    void* block = heap_allocate(size, alignment);
+    if (!block)
+        block = platform_allocated_aligned(size, alignment);
+    if (!block)
+    {
+        ACERROR("ac_allocate_aligned_t - failed to allocate %lluB aligned to %u.", size, alignment);
+        budget_release(size, tag);
+        return 0;
+    }
     platform_zero_mem(block, size);
 
+    record_allocate(size, tag, alignment_padding(alignment));
+
+    return block;
+}
+
+static void* allocate_large_block(u64 size, mem_tag tag)
+{
+    if (tag == MEMTAG_UNKNOWN)
+        ACWARN("ac_allocate_large_t called using MEMTAG_UNKNOWN, Re-Class this allocation");
+
+    if (!budget_charge(size, tag, TRUE))
+        return 0;
+
+    // fresh pages from the OS are already zero.
+    void* block = large_map(size);
+    if (!block)
+    {
+        ACERROR("ac_allocate_large_t - failed to map %lluB.", size);
+        budget_release(size, tag);
+        return 0;
+    }
+
+    record_allocate(size, tag, 0);
+    return block;
+}
+
+void* ac_allocate_t(u64 size, mem_tag tag)
+{
+    void* block = allocate_block(size, tag, TRUE);
+    alloc_tracker_add(block, size, tag, 0, 0);
+    return block;
+}
+
+void* ac_allocate_uninit_t(u64 size, mem_tag tag)
+{
+    void* block = allocate_block(size, tag, FALSE);
+    alloc_tracker_add(block, size, tag, 0, 0);
+    return block;
+}
+
+void* ac_allocate_aligned_t(u64 size, u16 alignment, mem_tag tag)
+{
+    void* block = allocate_aligned_block(size, alignment, tag);
+    alloc_tracker_add(block, size, tag, 0, 0);
+    return block;
+}
+
+void* ac_allocate_large_t(u64 size, mem_tag tag)
+{
+    void* block = allocate_large_block(size, tag);
+    alloc_tracker_add(block, size, tag, 0, 0);
+    return block;
+}
+
+#if ACMEMORY_TRACKING
+void* ac_allocate_tracked_t(u64 size, mem_tag tag, const char* file, u32 line)
+{
+    void* block = allocate_block(size, tag, TRUE);
+    alloc_tracker_add(block, size, tag, file, line);
+    return block;
+}
+
+void* ac_allocate_uninit_tracked_t(u64 size, mem_tag tag, const char* file, u32 line)
+{
+    void* block = allocate_block(size, tag, FALSE);
+    alloc_tracker_add(block, size, tag, file, line);
+    return block;
+}
+
+void* ac_allocate_aligned_tracked_t(u64 size, u16 alignment, mem_tag tag, const char* file, u32 line)
+{
+    void* block = allocate_aligned_block(size, alignment, tag);
+    alloc_tracker_add(block, size, tag, file, line);
+    return block;
+}
+
+void* ac_allocate_large_tracked_t(u64 size, mem_tag tag, const char* file, u32 line)
+{
+    void* block = allocate_large_block(size, tag);
+    alloc_tracker_add(block, size, tag, file, line);
     return block;
 }
+#endif
 
 void ac_free_t(void* block, u64 size, mem_tag tag)
 {
     if (tag == MEMTAG_UNKNOWN)
         ACWARN("ac_free called using MEMTAG_UNKNOWN, Re-Class this allocation");
 
-    stats.total_allocated -= size;
-    stats.tagged_allocation[tag] -= size;
+    if (!alloc_tracker_remove(block, size, tag))
+        return;
+
+    record_free(size, tag, 0);
+    budget_release(size, tag);
+
+    if (!heap_free(block))
+        platform_free(block, FALSE);
+}
+
+void ac_free_aligned_t(void* block, u64 size, u16 alignment, mem_tag tag)
+{
+    if (tag == MEMTAG_UNKNOWN)
+        ACWARN("ac_free_aligned_t called using MEMTAG_UNKNOWN, Re-Class this allocation");
+
+    if (!alloc_tracker_remove(block, size, tag))
+        return;
+
+    record_free(size, tag, alignment_padding(alignment));
+    budget_release(size, tag);
+
+    if (!heap_free(block))
+        platform_free_aligned(block);
+}
+
+void ac_free_large_t(void* block, u64 size, mem_tag tag)
+{
+    if (tag == MEMTAG_UNKNOWN)
+        ACWARN("ac_free_large_t called using MEMTAG_UNKNOWN, Re-Class this allocation");
+
+    if (!block)
+        return;
 
-    // TODO : set memory allignment
-    platform_free(block, FALSE);
+    if (!large_is_mapped(block))
+    {
+        ACERROR("ac_free_large_t - block %p was not allocated with ac_allocate_large_t.", block);
+        return;
+    }
+
+    if (!alloc_tracker_remove(block, size, tag))
+        return;
+
+    large_unmap(block);
+
+    record_free(size, tag, 0);
+    budget_release(size, tag);
 }
 
 void* ac_zero_memory_t(void* block, u64 size)
@@ -63,50 +725,328 @@ void* ac_copy_memory_t(void* dest, const void* source, u64 size)
     return platform_copy_mem(dest, source, size);
 }
 
+void* ac_move_memory_t(void* dest, const void* source, u64 size)
+{
+    return platform_move_mem(dest, source, size);
+}
+
 void* ac_set_memory_t(void* dest, i32 value, u64 size)
 {
     return platform_set_mem(dest, value, size);
 }
 
-char* ac_get_memory_usage_t()
+void* ac_copy_memory_stream_t(void* dest, const void* source, u64 size)
 {
-    const u64 Gib = 1024 * 1024 * 1024;
-    const u64 Mib = 1024 * 1024;
-    const u64 Kib = 1024;
+    return platform_stream_copy_mem(dest, source, size);
+}
 
-    char buffer[8000] = "System memory used (tagged):\n";
-    u64 offset = strlen(buffer);
-    for (u32 i = 0; i < MEMTAG_MAX_TAGS; ++i)
+void* ac_zero_memory_stream_t(void* block, u64 size)
+{
+    return platform_stream_zero_mem(block, size);
+}
+
+// ------------------------ benchmark ------------------------
+
+static f64 benchmark_gbps(u64 bytes, f64 seconds)
+{
+    return seconds > 0.0 ? (f64)bytes / seconds / 1e9 : 0.0;
+}
+
+// TRUE if dest holds the first size bytes of source, sampled once per page and at the end.
+static b8 benchmark_check(const u8* dest, const u8* source, u64 size)
+{
+    for (u64 i = 0; i < size; i += 4096)
+    {
+        if (dest[i] != source[i])
+            return FALSE;
+    }
+    return dest[size - 1] == source[size - 1];
+}
+
+void ac_memory_benchmark_t()
+{
+    static const u64 sizes[] = { 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024 };
+    static const u64 strides[] = { 8, 16, 24, 32 };
+    // every size moves this many bytes so the small ones still take measurable time.
+    const u64 bytes_per_run = 1024ull * 1024 * 1024;
+    const u64 max_size = sizes[sizeof(sizes) / sizeof(sizes[0]) - 1];
+
+    u8* source = ac_allocate_uninit_t(max_size, MEMTAG_ARRAY);
+    u8* dest = ac_allocate_uninit_t(max_size, MEMTAG_ARRAY);
+    if (!source || !dest)
+    {
+        ACERROR("ac_memory_benchmark_t - failed to allocate 2x %lluB.", max_size);
+        if (source)
+            ac_free_t(source, max_size, MEMTAG_ARRAY);
+        if (dest)
+            ac_free_t(dest, max_size, MEMTAG_ARRAY);
+        return;
+    }
+
+    // fault every page in before anything is timed.
+    for (u64 i = 0; i < max_size; ++i)
+        source[i] = (u8)(i * 131 + (i >> 12));
+    platform_set_mem(dest, 0, max_size);
+
+    ACINFO("memory benchmark, streaming stores use %s.", platform_stream_isa());
+    for (u32 s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s)
     {
-        char unit[4] = "XiB";
-        float amount = 1.0f;
-        if (stats.tagged_allocation[i] >= Gib)
+        u64 size = sizes[s];
+        u64 runs = bytes_per_run / size;
+
+        f64 start = platform_get_absolute_time();
+        for (u64 r = 0; r < runs; ++r)
+            ac_copy_memory_t(dest, source, size);
+        f64 copy_time = platform_get_absolute_time() - start;
+
+        platform_set_mem(dest, 0, size);
+        start = platform_get_absolute_time();
+        for (u64 r = 0; r < runs; ++r)
+            ac_copy_memory_stream_t(dest, source, size);
+        f64 stream_copy_time = platform_get_absolute_time() - start;
+        b8 stream_copy_ok = benchmark_check(dest, source, size);
+
+        start = platform_get_absolute_time();
+        for (u64 r = 0; r < runs; ++r)
+            ac_zero_memory_t(dest, size);
+        f64 zero_time = platform_get_absolute_time() - start;
+
+        start = platform_get_absolute_time();
+        for (u64 r = 0; r < runs; ++r)
+            ac_zero_memory_stream_t(dest, size);
+        f64 stream_zero_time = platform_get_absolute_time() - start;
+
+        ACINFO("memory %6llu KiB: copy %6.2f GB/s | stream copy %6.2f GB/s%s | zero %6.2f GB/s | stream zero %6.2f GB/s",
+               size / 1024,
+               benchmark_gbps(size * runs, copy_time),
+               benchmark_gbps(size * runs, stream_copy_time),
+               stream_copy_ok ? "" : " WRONG",
+               benchmark_gbps(size * runs, zero_time),
+               benchmark_gbps(size * runs, stream_zero_time));
+    }
+
+    // element copies within a cache resident 64KiB block, stride only known at runtime like in the containers.
+    const u64 block_size = 64 * 1024;
+    const u64 element_runs = bytes_per_run / 4 / block_size;
+    for (u32 s = 0; s < sizeof(strides) / sizeof(strides[0]); ++s)
+    {
+        u64 stride = *(volatile const u64*)&strides[s];
+        u64 count = block_size / stride;
+
+        f64 start = platform_get_absolute_time();
+        for (u64 r = 0; r < element_runs; ++r)
         {
-            unit[0] = 'G';
-            amount = stats.tagged_allocation[i] / (float)Gib;
+            for (u64 i = 0; i < count; ++i)
+                ac_copy_memory_t(dest + i * stride, source + i * stride, stride);
         }
-        else if (stats.tagged_allocation[i] >= Mib)
+        f64 copy_time = platform_get_absolute_time() - start;
+
+        platform_set_mem(dest, 0, block_size);
+        start = platform_get_absolute_time();
+        for (u64 r = 0; r < element_runs; ++r)
         {
-            unit[0] = 'M';
-            amount = stats.tagged_allocation[i] / (float)Mib;
+            for (u64 i = 0; i < count; ++i)
+                ac_copy_memory_small_t(dest + i * stride, source + i * stride, stride);
         }
-        else if (stats.tagged_allocation[i] >= Kib)
+        f64 small_time = platform_get_absolute_time() - start;
+        b8 small_ok = benchmark_check(dest, source, count * stride);
+
+        ACINFO("memory %2llu byte elements: copy %6.2f GB/s | small copy %6.2f GB/s%s",
+               stride,
+               benchmark_gbps(count * stride * element_runs, copy_time),
+               benchmark_gbps(count * stride * element_runs, small_time),
+               small_ok ? "" : " WRONG");
+    }
+
+    ac_free_t(source, max_size, MEMTAG_ARRAY);
+    ac_free_t(dest, max_size, MEMTAG_ARRAY);
+}
+
+void memory_register_linear_alloc(linear_alloc* alloc)
+{
+    registry_lock();
+    for (u32 i = 0; i < MAX_TRACKED_LINEAR_ALLOC; ++i)
+    {
+        if (linear_allocs[i] == 0)
         {
-            unit[0] = 'K';
-            amount = stats.tagged_allocation[i] / (float)Kib;
+            linear_allocs[i] = alloc;
+            registry_unlock();
+            return;
         }
-        else
+    }
+    registry_unlock();
+    ACWARN("Too many linear allocators, '%s' will not show in memory usage.", alloc->name);
+}
+
+void memory_unregister_linear_alloc(linear_alloc* alloc)
+{
+    registry_lock();
+    for (u32 i = 0; i < MAX_TRACKED_LINEAR_ALLOC; ++i)
+    {
+        if (linear_allocs[i] == alloc)
         {
-            unit[0] = 'B';
-            unit[1] = 0;
-            amount = (float)stats.tagged_allocation[i];
+            linear_allocs[i] = 0;
+            break;
         }
+    }
+    registry_unlock();
+}
 
-        i32 length = snprintf(buffer + offset, 8000, "  %s: %.2f%s\n", memtag_string[i], amount, unit);
-        offset += length;
+void memory_record_external_allocate(u64 size, mem_tag tag)
+{
+    budget_charge(size, tag, FALSE);
+    record_allocate(size, tag, 0);
+}
+
+void memory_record_external_free(u64 size, mem_tag tag)
+{
+    record_free(size, tag, 0);
+    budget_release(size, tag);
+}
+
+void ac_memory_set_budget_t(mem_tag tag, u64 soft_limit, u64 hard_limit)
+{
+    if (tag >= MEMTAG_MAX_TAGS)
+        return;
+
+    memory_budget* budget = &budgets[tag];
+    __atomic_store_n(&budget->enabled, FALSE, __ATOMIC_RELAXED);
+    if (soft_limit == 0 && hard_limit == 0)
+        return;
+
+    // NOTE: allocations racing with this call may be missed by the starting total.
+    memory_stats stats;
+    collect_stats(&stats);
+    budget->soft_limit = soft_limit;
+    budget->hard_limit = hard_limit;
+    budget->level = MEMORY_BUDGET_OK;
+    budget->changes = 0;
+    budget->dispatched = 0;
+    __atomic_store_n(&budget->current, stats.tags[tag].current, __ATOMIC_RELAXED);
+    __atomic_store_n(&budget->enabled, TRUE, __ATOMIC_RELEASE);
+}
+
+static const char* size_unit(u64 bytes, f32* out_amount)
+{
+    const u64 Gib = 1024 * 1024 * 1024;
+    const u64 Mib = 1024 * 1024;
+    const u64 Kib = 1024;
+
+    if (bytes >= Gib)
+    {
+        *out_amount = bytes / (f32)Gib;
+        return "GiB";
+    }
+    else if (bytes >= Mib)
+    {
+        *out_amount = bytes / (f32)Mib;
+        return "MiB";
+    }
+    else if (bytes >= Kib)
+    {
+        *out_amount = bytes / (f32)Kib;
+        return "KiB";
+    }
+
+    *out_amount = (f32)bytes;
+    return "B";
+}
+
+void ac_get_memory_stats_t(memory_stats* out_stats)
+{
+    if (out_stats)
+        collect_stats(out_stats);
+}
+
+const char* ac_memory_tag_name_t(mem_tag tag)
+{
+    return tag < MEMTAG_MAX_TAGS ? memtag_string[tag] : "INVALID";
+}
+
+u64 ac_memory_stats_format_t(const memory_stats* stats, char* buffer, u64 buffer_size)
+{
+    if (!stats || !buffer || buffer_size == 0)
+        return 0;
+
+    const u64 Kib = 1024;
+
+    string_builder builder;
+    ac_string_builder_create_t(buffer, buffer_size, &builder);
+    ac_string_builder_append_t(&builder, "System memory used (tagged):\n");
+    for (u32 i = 0; i < MEMTAG_MAX_TAGS; ++i)
+    {
+        f32 amount;
+        f32 peak_amount;
+        const char* unit = size_unit(stats->tags[i].current, &amount);
+        const char* peak_unit = size_unit(stats->tags[i].peak, &peak_amount);
+
+        ac_string_builder_format_t(&builder,
+                                   "  %s: %.2f%s (peak %.2f%s, %llu allocs, %llu frees)\n",
+                                   memtag_string[i],
+                                   amount,
+                                   unit,
+                                   peak_amount,
+                                   peak_unit,
+                                   stats->tags[i].alloc_count,
+                                   stats->tags[i].free_count);
+        if (stats->tags[i].soft_limit || stats->tags[i].hard_limit)
+        {
+            ac_string_builder_format_t(&builder,
+                                       "    budget: soft %.2fKiB, hard %.2fKiB\n",
+                                       stats->tags[i].soft_limit / (f32)Kib,
+                                       stats->tags[i].hard_limit / (f32)Kib);
+        }
+    }
+
+    f32 total_amount;
+    f32 total_peak_amount;
+    const char* total_unit = size_unit(stats->total_allocated, &total_amount);
+    const char* total_peak_unit = size_unit(stats->total_peak, &total_peak_amount);
+    ac_string_builder_format_t(&builder, "  Total: %.2f%s (peak %.2f%s)\n", total_amount, total_unit, total_peak_amount, total_peak_unit);
+    ac_string_builder_format_t(&builder, "  Alignment padding (worst case): %.2fKiB\n", stats->alignment_padding / (f32)Kib);
+
+    if (stats->heap.budget)
+    {
+        f32 used_amount;
+        f32 budget_amount;
+        f32 largest_amount;
+        const char* used_unit = size_unit(stats->heap.used, &used_amount);
+        const char* budget_unit = size_unit(stats->heap.budget, &budget_amount);
+        const char* largest_unit = size_unit(stats->heap.largest_free_block, &largest_amount);
+        ac_string_builder_format_t(&builder,
+                                   "  Heap: %.2f%s / %.2f%s, largest free block %.2f%s, %llu free blocks, %.1f%% fragmented, %llu fallbacks\n",
+                                   used_amount,
+                                   used_unit,
+                                   budget_amount,
+                                   budget_unit,
+                                   largest_amount,
+                                   largest_unit,
+                                   stats->heap.free_block_count,
+                                   stats->heap.fragmentation * 100.0f,
+                                   stats->heap.fallback_count);
+    }
+
+    if (stats->large_pages.block_count)
+    {
+        const u64 Mib = 1024 * 1024;
+        ac_string_builder_format_t(&builder,
+                                   "  Large pages: %.2fMiB huge, %.2fMiB transparent huge (requested), %.2fMiB normal, %u blocks\n",
+                                   stats->large_pages.huge / (f32)Mib,
+                                   stats->large_pages.transparent_huge / (f32)Mib,
+                                   stats->large_pages.normal / (f32)Mib,
+                                   stats->large_pages.block_count);
+    }
+
+    for (u32 i = 0; i < stats->linear_alloc_count; ++i)
+    {
+        const memory_linear_alloc_stats* alloc = &stats->linear_allocs[i];
+        ac_string_builder_format_t(&builder,
+                                   "  Linear '%s': %.2fKiB used, %.2fKiB high-water, %.2fKiB total\n",
+                                   alloc->name,
+                                   alloc->used / (f32)Kib,
+                                   alloc->high_water / (f32)Kib,
+                                   alloc->total_size / (f32)Kib);
     }
 
-    //char* out_string;
-    char* out_string = string_duplicate(buffer);
-    return out_string;
+    return builder.length;
 }
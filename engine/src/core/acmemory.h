@@ -21,16 +21,267 @@ typedef enum mem_tag
     MEMTAG_ENTITY,
     MEMTAG_ENTITY_NODE,
     MEMTAG_SCENE,
+    MEMTAG_LINEAR_ALLOC,
+
+    // vulkan host allocations, one per VkSystemAllocationScope.
+    MEMTAG_VULKAN_COMMAND,
+    MEMTAG_VULKAN_OBJECT,
+    MEMTAG_VULKAN_CACHE,
+    MEMTAG_VULKAN_DEVICE,
+    MEMTAG_VULKAN_INSTANCE,
 
     MEMTAG_MAX_TAGS,
 } mem_tag;
 
-ACAPI void memory_initialize();
+/* INFO:
+ * Size of the engine heap memory_initialize claims up front. With a budget every ac_allocate_*
+ * call is served from that one block (see memory/freelist_alloc.h) and the platform allocator is
+ * only used once the budget runs out. 0 sends every allocation to the platform allocator.
+ * Off on _DEBUG builds so sanitizers still see each block. Define it before including
+ * engine_entry.h to change it.
+ */
+#ifndef ACMEMORY_HEAP_BUDGET
+#if defined(_DEBUG)
+#define ACMEMORY_HEAP_BUDGET 0
+#else
+#define ACMEMORY_HEAP_BUDGET (256ull * 1024 * 1024)
+#endif
+#endif
+
+ACAPI void memory_initialize(u64 heap_budget);
 ACAPI void memory_shutdown();
 
+// Fires the EVENT_CODE_MEMORY_BUDGET events latched since the last call. Main thread, once per frame.
+ACAPI void memory_update();
+
 ACAPI void* ac_allocate_t(u64 size, mem_tag tag);
 ACAPI void ac_free_t(void* block, u64 size, mem_tag tag);
+
+/* INFO:
+ * Same as ac_allocate_t but skips zeroing the block. Use it when the caller overwrites
+ * the whole block anyway (copies, staging/vertex data). Free with ac_free_t.
+ *
+ * WARN: Content of the returned block is undefined.
+ */
+ACAPI void* ac_allocate_uninit_t(u64 size, mem_tag tag);
+
+/* INFO:
+ * Allocates a zeroed block whose address is a multiple of alignment.
+ * alignment: Power of two, e.g. 16/32/64 for SSE/AVX loads or to keep data on its own cache line.
+ *
+ * WARN: Blocks from here must be released with ac_free_aligned_t using the same size and alignment.
+ */
+ACAPI void* ac_allocate_aligned_t(u64 size, u16 alignment, mem_tag tag);
+ACAPI void ac_free_aligned_t(void* block, u64 size, u16 alignment, mem_tag tag);
+
+/* INFO:
+ * Allocates a zeroed block for big, long lived pools (entity storage, asset caches, staging data).
+ * The block comes straight from the OS, aligned to 2MiB and backed by huge pages when the system
+ * allows it, falling back to transparent huge pages and then normal pages. The memory report shows
+ * which kind of pages each byte landed on.
+ *
+ * WARN: Every call maps at least 2MiB, do not use it for small blocks.
+ */
+ACAPI void* ac_allocate_large_t(u64 size, mem_tag tag);
+ACAPI void ac_free_large_t(void* block, u64 size, mem_tag tag);
+
+/* INFO:
+ * Allocation tracking. When enabled every block records its size, tag, file and line,
+ * memory_shutdown reports blocks that were never freed and ac_free_t checks the size/tag
+ * it is given. Enabled by default on _DEBUG builds, compiled out otherwise.
+ */
+#ifndef ACMEMORY_TRACKING
+#if defined(_DEBUG)
+#define ACMEMORY_TRACKING 1
+#else
+#define ACMEMORY_TRACKING 0
+#endif
+#endif
+
+#if ACMEMORY_TRACKING
+ACAPI void* ac_allocate_tracked_t(u64 size, mem_tag tag, const char* file, u32 line);
+ACAPI void* ac_allocate_uninit_tracked_t(u64 size, mem_tag tag, const char* file, u32 line);
+ACAPI void* ac_allocate_aligned_tracked_t(u64 size, u16 alignment, mem_tag tag, const char* file, u32 line);
+ACAPI void* ac_allocate_large_tracked_t(u64 size, mem_tag tag, const char* file, u32 line);
+
+#define ac_allocate_t(size, tag) ac_allocate_tracked_t(size, tag, __FILE__, __LINE__)
+#define ac_allocate_uninit_t(size, tag) ac_allocate_uninit_tracked_t(size, tag, __FILE__, __LINE__)
+#define ac_allocate_aligned_t(size, alignment, tag) ac_allocate_aligned_tracked_t(size, alignment, tag, __FILE__, __LINE__)
+#define ac_allocate_large_t(size, tag) ac_allocate_large_tracked_t(size, tag, __FILE__, __LINE__)
+#endif
+
 ACAPI void* ac_zero_memory_t(void* block, u64 size);
 ACAPI void* ac_copy_memory_t(void* dest, const void* source, u64 size);
+// copy where source and dest may overlap (shifting elements inside one array).
+ACAPI void* ac_move_memory_t(void* dest, const void* source, u64 size);
 ACAPI void* ac_set_memory_t(void* dest, i32 value, u64 size);
-ACAPI char* ac_get_memory_usage_t();
+
+/* INFO:
+ * Copy/zero for multi-megabyte buffers (staging data, big resets) that will not be read again soon.
+ * Uses non-temporal stores so the data does not evict the cache, smaller sizes use the plain path.
+ *
+ * WARN: Slower than ac_copy_memory_t when the destination is read right after.
+ */
+ACAPI void* ac_copy_memory_stream_t(void* dest, const void* source, u64 size);
+ACAPI void* ac_zero_memory_stream_t(void* block, u64 size);
+
+/* INFO:
+ * Logs memcpy/memset against the streaming copy/zero for 1MiB to 64MiB buffers, and
+ * ac_copy_memory_t against ac_copy_memory_small_t for 8 to 32 byte elements.
+ * Allocates about 128MB while it runs.
+ */
+ACAPI void ac_memory_benchmark_t();
+
+/* PERF:
+ * Copy for a handful of bytes (one container element). Inlined, the common
+ * sizes become one or two register moves instead of a call into memcpy.
+ */
+static inline void* ac_copy_memory_small_t(void* dest, const void* source, u64 size)
+{
+    u8* d = (u8*)dest;
+    const u8* s = (const u8*)source;
+    switch (size)
+    {
+    case 1:
+        __builtin_memcpy(d, s, 1);
+        return dest;
+    case 2:
+        __builtin_memcpy(d, s, 2);
+        return dest;
+    case 4:
+        __builtin_memcpy(d, s, 4);
+        return dest;
+    case 8:
+        __builtin_memcpy(d, s, 8);
+        return dest;
+    case 16:
+        __builtin_memcpy(d, s, 16);
+        return dest;
+    default:
+        break;
+    }
+
+    // 9..32 bytes: two overlapping 8/16 byte moves cover any length.
+    if (size > 8 && size <= 16)
+    {
+        u64 head, tail;
+        __builtin_memcpy(&head, s, 8);
+        __builtin_memcpy(&tail, s + size - 8, 8);
+        __builtin_memcpy(d, &head, 8);
+        __builtin_memcpy(d + size - 8, &tail, 8);
+        return dest;
+    }
+    if (size > 16 && size <= 32)
+    {
+        u8 head[16], tail[16];
+        __builtin_memcpy(head, s, 16);
+        __builtin_memcpy(tail, s + size - 16, 16);
+        __builtin_memcpy(d, head, 16);
+        __builtin_memcpy(d + size - 16, tail, 16);
+        return dest;
+    }
+    return ac_copy_memory_t(dest, source, size);
+}
+
+// allocators that want their usage in the memory report.
+#define MAX_TRACKED_LINEAR_ALLOC 16
+
+typedef enum memory_budget_level
+{
+    MEMORY_BUDGET_OK = 0,
+    MEMORY_BUDGET_SOFT, // soft limit crossed, allocations still succeed.
+    MEMORY_BUDGET_HARD, // an allocation was refused because it would cross the hard limit.
+} memory_budget_level;
+
+/* INFO:
+ * Limits how much a tag may hold. 0 disables a limit, both 0 removes the budget.
+ * soft_limit: Crossing it logs a warning and fires EVENT_CODE_MEMORY_BUDGET so systems can evict.
+ * hard_limit: Allocations that would cross it fail (return 0) and fire EVENT_CODE_MEMORY_BUDGET.
+ * The event fires when the level changes, not for every allocation. It is queued and fired
+ * from memory_update on the main thread, never from inside ac_allocate_t/ac_free_t.
+ *
+ * NOTE: Usage starts from the tag's current usage. Tags without a budget cost nothing extra.
+ * Memory recorded with memory_record_external_allocate counts but is never refused.
+ * WARN: Only give a hard limit to tags whose callers handle 0:
+ *       MEMTAG_DICT (a create leaves the map empty, an insert that can't grow returns 0),
+ *       a tag used only by slot_maps or pool_allocs (insert/allocate fail), MEMTAG_BST (btree insert
+ *       returns FALSE) and MEMTAG_VULKAN_* (the driver gets VK_ERROR_OUT_OF_HOST_MEMORY).
+ *       Not MEMTAG_DYN_ARRAY: the array survives a refused grow, but the renderer writes through
+ *       its creates and indexes its arrays by what it pushed. Other callers don't check either.
+ */
+ACAPI void ac_memory_set_budget_t(mem_tag tag, u64 soft_limit, u64 hard_limit);
+
+typedef struct memory_tag_stats
+{
+    u64 current; // bytes
+    u64 peak;    // bytes
+    u64 alloc_count;
+    u64 free_count;
+    u64 soft_limit; // 0 = no limit.
+    u64 hard_limit; // 0 = no limit.
+} memory_tag_stats;
+
+typedef struct memory_linear_alloc_stats
+{
+    const char* name;
+    u64 used;
+    u64 high_water;
+    u64 total_size;
+} memory_linear_alloc_stats;
+
+typedef struct memory_heap_stats
+{
+    u64 budget; // 0 when the engine heap is not used.
+    u64 used;   // headers and alignment padding included.
+    u64 largest_free_block;
+    u64 free_block_count;
+    f32 fragmentation;  // 1 - largest free block / free bytes.
+    u64 fallback_count; // allocations sent to the platform allocator because the heap was full.
+} memory_heap_stats;
+
+// page rounded bytes mapped by ac_allocate_large_t and the engine heap, by page kind.
+typedef struct memory_large_page_stats
+{
+    u64 huge;             // explicit huge pages (MAP_HUGETLB / MEM_LARGE_PAGES).
+    u64 transparent_huge; // THP requested with madvise, the kernel may still use normal pages.
+    u64 normal;           // no huge pages available.
+    u32 block_count;
+} memory_large_page_stats;
+
+typedef struct memory_stats
+{
+    u64 total_allocated;
+    u64 total_peak;
+    u64 alignment_padding; // worst case
+    memory_tag_stats tags[MEMTAG_MAX_TAGS];
+    memory_heap_stats heap;
+    memory_large_page_stats large_pages;
+
+    u32 linear_alloc_count;
+    memory_linear_alloc_stats linear_allocs[MAX_TRACKED_LINEAR_ALLOC];
+} memory_stats;
+
+// buffer size that fits a full ac_memory_stats_format_t report.
+#define MEMORY_STATS_FORMAT_SIZE 8000
+
+/* INFO:
+ * Fills out_stats with the current memory usage. Does not allocate, safe to call every frame.
+ * Peak values are the highest usage reached since memory_initialize, recorded by the allocations.
+ */
+ACAPI void ac_get_memory_stats_t(memory_stats* out_stats);
+
+ACAPI const char* ac_memory_tag_name_t(mem_tag tag);
+
+/* INFO:
+ * Writes a human readable report of stats into buffer (always null terminated).
+ * Returns: Number of characters written, without the null terminator.
+ */
+ACAPI u64 ac_memory_stats_format_t(const memory_stats* stats, char* buffer, u64 buffer_size);
+
+struct linear_alloc;
+void memory_register_linear_alloc(struct linear_alloc* alloc);
+void memory_unregister_linear_alloc(struct linear_alloc* alloc);
+
+// account memory that does not come from ac_allocate_t (e.g. committed virtual memory) under a tag.
+void memory_record_external_allocate(u64 size, mem_tag tag);
+void memory_record_external_free(u64 size, mem_tag tag);
@@ -6,6 +6,9 @@
 #include "core/acmemory.h"
 #include "core/event.h"
 #include "core/input.h"
+#include "core/string_id.h"
+#include "memory/linear_alloc.h"
+#include "memory/stack_alloc.h"
 #include "platform/platform.h"
 #include <core/clock.h>
 
@@ -21,8 +24,11 @@ typedef struct
     i16 height;
     clock clock;
     i16 last_time;
+    linear_alloc frame_alloc; // scratch memory, reset at the top of every frame.
 } application_state;
 
+#define FRAME_ALLOC_SIZE (1024 * 1024)
+
 static b8 initialized = FALSE;
 static application_state app_state;
 
@@ -43,6 +49,12 @@ b8 application_create(game* game_inst)
     init_log();
     input_initialize();
 
+    if (!string_table_initialize())
+    {
+        ACERROR("String table failed to Initialized!");
+        return FALSE;
+    }
+
     // ACFATAL("Test Message: %f", 20.0f);
     // ACERROR("Test Message: %f", 20.0f);
     // ACWARN("Test Message: %f", 20.0f);
@@ -101,10 +113,21 @@ b8 application_run()
     u8 frame_count = 0;
     f64 target_frame_seconds = 1.0f / 60;
 
-    ACINFO(ac_get_memory_usage_t());
+    ac_linear_alloc_create_t("frame", FRAME_ALLOC_SIZE, 0, &app_state.frame_alloc);
+
+    memory_stats mem_stats;
+    ac_get_memory_stats_t(&mem_stats);
+    char mem_usage[MEMORY_STATS_FORMAT_SIZE];
+    ac_memory_stats_format_t(&mem_stats, mem_usage, sizeof(mem_usage));
+    ACINFO("%s", mem_usage);
 
     while (app_state.is_running)
     {
+        // anything allocated from the frame allocator only lives for one frame.
+        ac_linear_alloc_reset_t(&app_state.frame_alloc);
+        // budget events latched by the allocator during the last frame.
+        memory_update();
+
         if (!platform_push_msg(&app_state.platform))
             app_state.is_running = FALSE;
 
@@ -163,11 +186,20 @@ b8 application_run()
     event_shutdown();
     input_shutdown();
     renderer_shutdown();
+    string_table_shutdown();
+
+    ac_linear_alloc_destroy_t(&app_state.frame_alloc);
+    ac_stack_alloc_thread_release_t();
 
     platform_shutdown(&app_state.platform);
     return TRUE;
 }
 
+linear_alloc* application_get_frame_alloc()
+{
+    return app_state.frame_alloc.memory ? &app_state.frame_alloc : 0;
+}
+
 void application_get_framebuffer_size(u32* width, u32* height)
 {
     *width = app_state.width;
@@ -3,6 +3,7 @@
 #include "define.h"
 
 struct game;
+struct linear_alloc;
 
 typedef struct application_config
 {
@@ -18,3 +19,6 @@ ACAPI b8 application_create(struct game* game_inst);
 ACAPI b8 application_run();
 
 void application_get_framebuffer_size(u32* width, u32* height);
+
+// Per-frame scratch allocator. Everything allocated from it is released at the start of the next frame.
+ACAPI struct linear_alloc* application_get_frame_alloc();
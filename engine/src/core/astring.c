@@ -1,5 +1,6 @@
 #include "core/astring.h"
 #include "core/acmemory.h"
+#include "memory/linear_alloc.h"
 #include <string.h>
 
 u64 string_length(const char* str)
@@ -10,12 +11,35 @@ u64 string_length(const char* str)
 char* string_duplicate(const char* str)
 {
     u64 length = string_length(str);
-    char* copy = ac_allocate_t(length + 1, MEMTAG_STRING);
+    char* copy = ac_allocate_uninit_t(length + 1, MEMTAG_STRING);
     ac_copy_memory_t(copy, str, length + 1);
     return copy;
 }
 
 b8 string_equal(const char *str0, const char *str1)
 {
-    return strcmp(str0, str1);
+    return strcmp(str0, str1) == 0;
+}
+
+string_view string_view_create(const char* str)
+{
+    return string_view_create_n(str, str ? string_length(str) : 0);
+}
+
+b8 string_view_equal(string_view a, string_view b)
+{
+    if (a.length != b.length)
+        return FALSE;
+    return a.str == b.str || memcmp(a.str, b.str, a.length) == 0;
+}
+
+string_view string_view_copy(struct linear_alloc* alloc, string_view view)
+{
+    char* copy = ac_linear_alloc_allocate_t(alloc, view.length + 1);
+    if (!copy)
+        return string_view_create_n(0, 0);
+
+    ac_copy_memory_t(copy, view.str, view.length);
+    copy[view.length] = 0;
+    return string_view_create_n(copy, view.length);
 }
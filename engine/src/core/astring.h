@@ -2,9 +2,40 @@
 
 #include "define.h"
 
+struct linear_alloc;
+
 // Returns the length of the given string.
+// NOTE: scans the whole string every call, keep a string_view when the length is needed again.
 ACAPI u64 string_length(const char* str);
 ACAPI char* string_duplicate(const char* str);
 
 // Case-sensitive string compare. true if same, otherwise false
+// NOTE: for names compared often, intern them (core/string_id.h) and compare the ids.
 ACAPI b8 string_equal(const char* str0, const char* str1);
+
+/* INFO:
+ * Pointer + length into characters owned by someone else. The length is
+ * measured once, comparing two views checks the lengths before the bytes.
+ * str is not guaranteed to be null terminated unless the view says so.
+ */
+typedef struct string_view
+{
+    const char* str;
+    u64 length;
+} string_view;
+
+ACAPI string_view string_view_create(const char* str);
+
+static inline string_view string_view_create_n(const char* str, u64 length)
+{
+    string_view view = { str, length };
+    return view;
+}
+
+ACAPI b8 string_view_equal(string_view a, string_view b);
+
+/* INFO:
+ * Copies view into alloc with a null terminator, no heap allocation.
+ * Returns: View of the copy, or an empty view if alloc is full.
+ */
+ACAPI string_view string_view_copy(struct linear_alloc* alloc, string_view view);
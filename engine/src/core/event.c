@@ -1,6 +1,7 @@
 #include "core/event.h"
-#include "container/dyn_array.h"
+#include "container/small_array.h"
 #include "core/acmemory.h"
+#include "core/logger.h"
 
 typedef struct registered_event
 {
@@ -8,9 +9,12 @@ typedef struct registered_event
     pfn_on_event callback;
 } registered_event;
 
+// most codes have one or two listeners, those never allocate. 48 bytes per code.
+#define EVENT_INLINE_LISTENERS 2
+
 typedef struct event_code_entry
 {
-    registered_event* events;
+    SMALL_ARRAY(registered_event, EVENT_INLINE_LISTENERS) events;
 } event_code_entry;
 
 #define MAX_MSG_CODES 8384
@@ -18,13 +22,33 @@ typedef struct event_code_entry
 // state structure
 typedef struct event_sys_state
 {
-    // lookup table for event codes.
-    event_code_entry registered[MAX_MSG_CODES];
+    // system codes (0..MAX_EVENT_CODE) are looked up inline, 12KB.
+    event_code_entry system[MAX_EVENT_CODE + 1];
+    // application codes get their entry on the first register, 8 bytes per unused code.
+    event_code_entry* application[MAX_MSG_CODES - MAX_EVENT_CODE - 1];
 } event_sys_state;
 
 static b8 is_initialized = FALSE;
 static event_sys_state state;
 
+// entry of code, 0 if nothing registered for it yet (or create failed / code out of range).
+static event_code_entry* event_entry(u16 code, b8 create)
+{
+    if (code <= MAX_EVENT_CODE)
+        return &state.system[code];
+    if (code >= MAX_MSG_CODES)
+    {
+        if (create)
+            ACERROR("Event code %u is outside of the table (max %u).", code, MAX_MSG_CODES - 1);
+        return 0;
+    }
+
+    event_code_entry** slot = &state.application[code - MAX_EVENT_CODE - 1];
+    if (!*slot && create)
+        *slot = ac_allocate_t(sizeof(event_code_entry), MEMTAG_APPLICATION);
+    return *slot;
+}
+
 b8 event_initialize()
 {
     if (is_initialized == TRUE)
@@ -41,13 +65,17 @@ b8 event_initialize()
 
 void event_shutdown()
 {
-    for (u16 i = 0; i < MAX_MSG_CODES; ++i)
+    for (u16 i = 0; i <= MAX_EVENT_CODE; ++i)
+        ac_small_array_destroy_t(&state.system[i].events);
+
+    for (u16 i = 0; i < MAX_MSG_CODES - MAX_EVENT_CODE - 1; ++i)
     {
-        if (state.registered[i].events != 0)
-        {
-            ac_dyn_array_destroy_t(state.registered[i].events);
-            state.registered[i].events = 0;
-        }
+        event_code_entry* entry = state.application[i];
+        if (!entry)
+            continue;
+        ac_small_array_destroy_t(&entry->events);
+        ac_free_t(entry, sizeof(event_code_entry), MEMTAG_APPLICATION);
+        state.application[i] = 0;
     }
 }
 
@@ -56,13 +84,15 @@ b8 ac_event_register_t(u16 code, void* listener, pfn_on_event on_event)
     if (is_initialized == FALSE)
         return FALSE;
 
-    if (state.registered[code].events == 0)
-        state.registered[code].events = ac_dyn_array_create_t(registered_event);
+    event_code_entry* entry = event_entry(code, TRUE);
+    if (!entry)
+        return FALSE;
 
-    u64 reg_count = ac_dyn_array_length_t(state.registered[code].events);
+    registered_event* events = ac_small_array_data_t(&entry->events);
+    u64 reg_count = ac_small_array_length_t(&entry->events);
     for (u64 i = 0; i < reg_count; ++i)
     {
-        if (state.registered[code].events[i].listener == listener)
+        if (events[i].listener == listener)
         {
             return FALSE;
         }
@@ -71,8 +101,7 @@ b8 ac_event_register_t(u16 code, void* listener, pfn_on_event on_event)
     registered_event event;
     event.listener = listener;
     event.callback = on_event;
-    ac_dyn_array_push_t(state.registered[code].events, event);
-    return TRUE;
+    return ac_small_array_push_ptr_t(&entry->events, &event);
 }
 
 b8 ac_event_unregister_t(u16 code, void* listener, pfn_on_event on_event)
@@ -80,19 +109,20 @@ b8 ac_event_unregister_t(u16 code, void* listener, pfn_on_event on_event)
     if (is_initialized == FALSE)
         return FALSE;
 
-    if (state.registered[code].events == 0)
-    {
+    event_code_entry* entry = event_entry(code, FALSE);
+    if (!entry)
         return FALSE;
-    }
 
-    u64 reg_count = ac_dyn_array_length_t(state.registered[code].events);
+    registered_event* events = ac_small_array_data_t(&entry->events);
+    u64 reg_count = ac_small_array_length_t(&entry->events);
     for (u64 i = 0; i < reg_count; ++i)
     {
-        registered_event e = state.registered[code].events[i];
+        registered_event e = events[i];
         if (e.listener == listener && e.callback == on_event)
         {
-            registered_event popped_event;
-            ac_dyn_array_pop_at_t(state.registered[code].events, i, &popped_event);
+            // NOTE: ordered removal on purpose, listeners are dispatched in registration order
+            // and the first one that handles the event stops it. swap_remove would reorder them.
+            ac_small_array_pop_at_t(&entry->events, i, 0);
             return TRUE;
         }
     }
@@ -105,13 +135,15 @@ b8 ac_event_fire_t(u16 code, void* sender, event_context context)
     if (is_initialized == FALSE)
         return FALSE;
 
-    if (state.registered[code].events == 0)
+    event_code_entry* entry = event_entry(code, FALSE);
+    if (!entry)
         return FALSE;
 
-    u64 reg_count = ac_dyn_array_length_t(state.registered[code].events);
+    registered_event* events = ac_small_array_data_t(&entry->events);
+    u64 reg_count = ac_small_array_length_t(&entry->events);
     for (u64 i = 0; i < reg_count; ++i)
     {
-        registered_event e = state.registered[code].events[i];
+        registered_event e = events[i];
         if (e.callback(code, sender, e.listener, context))
             return TRUE;
     }
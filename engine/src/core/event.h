@@ -44,6 +44,7 @@ void event_shutdown();
  * Returns: True if the registration was successful, false otherwise.
  *
  * WARN: Event with multiple callback/listener will not register and will cause this to return FALSE
+ *       Also FALSE when the listener list could not grow or code is 8384 or above.
  */
 ACAPI b8 ac_event_register_t(u16 code, void* listener, pfn_on_event on_event);
 
@@ -84,5 +85,15 @@ typedef enum sys_event_code
     EVENT_CODE_MOUSE_MOVE = 0x06,       // mouse moved
     EVENT_CODE_MOUSE_WHEEL = 0x07,      // mouse wheel
     EVENT_CODE_RESIZED = 0x08,          // resize window
+
+    /* INFO:
+     * A tag crossed one of its memory budget limits (see ac_memory_set_budget_t).
+     * data.u32[0]: mem_tag
+     * data.u32[1]: memory_budget_level reached, MEMORY_BUDGET_OK when usage went back under the soft limit.
+     * data.u64[1]: bytes currently allocated under the tag.
+     *
+     * NOTE: Fired from memory_update on the main thread, once per frame at most for each tag.
+     */
+    EVENT_CODE_MEMORY_BUDGET = 0x09,
     MAX_EVENT_CODE = 0xFF
 } sys_event_code;
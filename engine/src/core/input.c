@@ -1,11 +1,13 @@
 #include "core/input.h"
+#include "container/bitset.h"
 #include "core/event.h"
 #include "core/acmemory.h"
 #include "core/logger.h"
 
+// one bit per key, the per-frame copy to kbd_prev is 32 bytes.
 typedef struct keyboard_state
 {
-    b8 keys[256];
+    u64 keys[BITSET_WORDS(256)];
 } keyboard_state;
 
 typedef struct mouse_state
@@ -50,10 +52,10 @@ void input_shutdown()
 
 void input_process_key(keys key, b8 pressed)
 {
-    if (state.kbd_current.keys[key] != pressed)
+    if (ac_bits_test_t(state.kbd_current.keys, key) != pressed)
     {
         // update internal state
-        state.kbd_current.keys[key] = pressed;
+        ac_bits_assign_t(state.kbd_current.keys, key, pressed);
 
         event_context context;
         context.data.u16[0] = key;
@@ -103,28 +105,28 @@ b8 input_key_down(keys key)
 {
     if (!initialized)
         return FALSE;
-    return state.kbd_current.keys[key] == TRUE;
+    return ac_bits_test_t(state.kbd_current.keys, key);
 }
 
 b8 input_key_up(keys key)
 {
     if (!initialized)
         return TRUE;
-    return state.kbd_current.keys[key] == FALSE;
+    return !ac_bits_test_t(state.kbd_current.keys, key);
 }
 
 b8 input_was_key_down(keys key)
 {
     if (!initialized)
         return FALSE;
-    return state.kbd_prev.keys[key] == TRUE;
+    return ac_bits_test_t(state.kbd_prev.keys, key);
 }
 
 b8 input_was_key_up(keys key)
 {
     if (!initialized)
         return TRUE;
-    return state.kbd_prev.keys[key] == FALSE;
+    return !ac_bits_test_t(state.kbd_prev.keys, key);
 }
 
 // ----------------- mouse input --------------------
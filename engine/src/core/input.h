@@ -149,7 +149,7 @@ void input_shutdown();
 ACAPI b8 input_key_down(keys key);
 ACAPI b8 input_key_up(keys key);
 ACAPI b8 input_was_key_down(keys key);
-ACAPI b8 input_was_key_down(keys key);
+ACAPI b8 input_was_key_up(keys key);
 
 void input_process_key(keys key, b8 pressed);
 
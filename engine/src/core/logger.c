@@ -1,10 +1,9 @@
 #include "logger.h"
 #include "assertion.h"
+#include "core/string_builder.h"
 #include "platform/platform.h"
 
 #include <stdarg.h>
-#include <stdio.h>
-#include <string.h>
 
 void report_assert_failure(const char* expression, const char* msg, const char* file, i32 line)
 {
@@ -23,25 +22,29 @@ void log_output(log_type type, const char* message, ...)
     const char* level_strings[6] = { "[ENGINE-FATAL]: ", "[ENGINE-ERROR]: ", "[ENGINE-WARN]: ", "[ENGINE-INFO]: ", "[ENGINE-DEBUG]: ", "[ENGINE-TRACE]: " };
     b8 is_error = type < LOG_TYPE_WARN;
 
-    const i16 length = 16000;
-    char out_message[length];
-    memset(out_message, 0, sizeof(out_message));
+    // prefix, message and newline go straight into one buffer, no zeroing, no second copy.
+    char out_message[LOG_MESSAGE_SIZE];
+    string_builder builder;
+    ac_string_builder_create_t(out_message, sizeof(out_message), &builder);
+    ac_string_builder_append_t(&builder, level_strings[type]);
 
     // Create formatted message in string
     __builtin_va_list arg_ptr;
     va_start(arg_ptr, message);
-    vsnprintf(out_message, length, message, arg_ptr);
+    ac_string_builder_vformat_t(&builder, message, arg_ptr);
     va_end(arg_ptr);
 
-    char out_message2[length];
-    sprintf(out_message2, "%s%s\n", level_strings[type], out_message);
+    ac_string_builder_append_char_t(&builder, '\n');
+    // a cut message still ends its line.
+    if (builder.truncated)
+        out_message[builder.length - 1] = '\n';
 
     if (is_error)
     {
-        platform_console_write_error(out_message2, type);
+        platform_console_write_error(out_message, type);
     }
     else
     {
-        platform_console_write(out_message2, type);
+        platform_console_write(out_message, type);
     }
 }
@@ -23,6 +23,9 @@ typedef enum log_type
     LOG_TYPE_TRACE,
 } log_type;
 
+// longest line log_output writes, longer messages are cut.
+#define LOG_MESSAGE_SIZE 16000
+
 b8 init_log();
 void shutdown_log();
 
@@ -0,0 +1,481 @@
+#include "core/sort.h"
+#include "core/acmemory.h"
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <stdlib.h>
+
+#define RADIX_BUCKETS 256
+
+// --------------------- spin barrier ---------------------
+
+// workers only wait for each other between passes, a pass is far shorter than a sleep/wake round trip.
+// past SORT_BARRIER_SPINS the waiter yields, so more workers than free cores still make progress.
+#define SORT_BARRIER_SPINS 1024
+
+typedef struct sort_barrier
+{
+    u32 count;
+    u32 waiting;
+    u32 generation;
+} sort_barrier;
+
+static inline void cpu_relax()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static void sort_barrier_wait(sort_barrier* barrier)
+{
+    u32 generation = __atomic_load_n(&barrier->generation, __ATOMIC_ACQUIRE);
+    if (__atomic_add_fetch(&barrier->waiting, 1, __ATOMIC_ACQ_REL) == barrier->count)
+    {
+        __atomic_store_n(&barrier->waiting, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&barrier->generation, generation + 1, __ATOMIC_RELEASE);
+        return;
+    }
+    for (u32 spins = 0; __atomic_load_n(&barrier->generation, __ATOMIC_ACQUIRE) == generation; ++spins)
+    {
+        if (spins < SORT_BARRIER_SPINS)
+            cpu_relax();
+        else
+            platform_thread_yield();
+    }
+}
+
+// ------------------ shared multithread state ------------------
+
+typedef struct radix_sort_mt_state
+{
+    void* keys;
+    void* temp_keys;
+    u32* values;
+    u32* temp_values;
+    u64 count;
+    u32 worker_count;
+    u32 start; // 0 while the workers are being created, 1 once worker_count is final.
+    u64* all_hist;  // [worker][digit][bucket], every digit of the original chunk.
+    u64* pass_hist; // [worker][bucket], the chunk of the current pass.
+    sort_barrier barrier;
+} radix_sort_mt_state;
+
+typedef struct radix_sort_mt_worker
+{
+    radix_sort_mt_state* state;
+    u32 index;
+    platform_thread thread;
+} radix_sort_mt_worker;
+
+static void mt_wait_start(radix_sort_mt_state* state)
+{
+    while (!__atomic_load_n(&state->start, __ATOMIC_ACQUIRE))
+        platform_thread_yield();
+}
+
+// a pass can be skipped when every key has the same byte there.
+static b8 digit_is_uniform(const u64* totals, u64 count)
+{
+    for (u32 b = 0; b < RADIX_BUCKETS; ++b)
+    {
+        if (totals[b] == count)
+            return TRUE;
+        if (totals[b])
+            return FALSE;
+    }
+    return FALSE;
+}
+
+/* INFO:
+ * Sort routines for one key type. digit_count is the number of bytes per key.
+ * scatter writes src[begin, end) to dst at offsets, advancing them, which keeps equal keys in order.
+ */
+#define RADIX_SORT_DEFINE(suffix, key_type, digit_count)                                                                                   \
+    static void insertion_sort_##suffix(key_type* keys, u32* values, u64 count)                                                            \
+    {                                                                                                                                      \
+        for (u64 i = 1; i < count; ++i)                                                                                                    \
+        {                                                                                                                                  \
+            key_type key = keys[i];                                                                                                        \
+            u32 value = values ? values[i] : 0;                                                                                            \
+            u64 j = i;                                                                                                                     \
+            for (; j > 0 && keys[j - 1] > key; --j)                                                                                        \
+            {                                                                                                                              \
+                keys[j] = keys[j - 1];                                                                                                     \
+                if (values)                                                                                                                \
+                    values[j] = values[j - 1];                                                                                             \
+            }                                                                                                                              \
+            keys[j] = key;                                                                                                                 \
+            if (values)                                                                                                                    \
+                values[j] = value;                                                                                                         \
+        }                                                                                                                                  \
+    }                                                                                                                                      \
+                                                                                                                                           \
+    static void histogram_##suffix(const key_type* keys, u64 begin, u64 end, u64* hist)                                                   \
+    {                                                                                                                                      \
+        for (u64 i = begin; i < end; ++i)                                                                                                  \
+        {                                                                                                                                  \
+            key_type key = keys[i];                                                                                                        \
+            for (u32 d = 0; d < digit_count; ++d)                                                                                          \
+                hist[d * RADIX_BUCKETS + ((key >> (d * 8)) & 0xFF)]++;                                                                     \
+        }                                                                                                                                  \
+    }                                                                                                                                      \
+                                                                                                                                           \
+    static void scatter_##suffix(const key_type* src_keys,                                                                                 \
+                                 const u32* src_values,                                                                                    \
+                                 key_type* dst_keys,                                                                                       \
+                                 u32* dst_values,                                                                                          \
+                                 u64 begin,                                                                                                \
+                                 u64 end,                                                                                                  \
+                                 u32 shift,                                                                                                \
+                                 u64* offsets)                                                                                             \
+    {                                                                                                                                      \
+        if (src_values)                                                                                                                    \
+        {                                                                                                                                  \
+            for (u64 i = begin; i < end; ++i)                                                                                              \
+            {                                                                                                                              \
+                key_type key = src_keys[i];                                                                                                \
+                u64 position = offsets[(key >> shift) & 0xFF]++;                                                                           \
+                dst_keys[position] = key;                                                                                                  \
+                dst_values[position] = src_values[i];                                                                                      \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+        else                                                                                                                               \
+        {                                                                                                                                  \
+            for (u64 i = begin; i < end; ++i)                                                                                              \
+            {                                                                                                                              \
+                key_type key = src_keys[i];                                                                                                \
+                dst_keys[offsets[(key >> shift) & 0xFF]++] = key;                                                                          \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+    }                                                                                                                                      \
+                                                                                                                                           \
+    static void radix_sort_##suffix(key_type* keys, u32* values, u64 count)                                                               \
+    {                                                                                                                                      \
+        if (count < 2)                                                                                                                     \
+            return;                                                                                                                        \
+        if (count < RADIX_SORT_SMALL_COUNT)                                                                                                \
+        {                                                                                                                                  \
+            insertion_sort_##suffix(keys, values, count);                                                                                  \
+            return;                                                                                                                        \
+        }                                                                                                                                  \
+                                                                                                                                           \
+        u64 hist[digit_count * RADIX_BUCKETS] = { 0 };                                                                                     \
+        histogram_##suffix(keys, 0, count, hist);                                                                                          \
+                                                                                                                                           \
+        key_type* temp_keys = ac_allocate_uninit_t(count * sizeof(key_type), MEMTAG_ARRAY);                                                \
+        u32* temp_values = values ? ac_allocate_uninit_t(count * sizeof(u32), MEMTAG_ARRAY) : 0;                                           \
+        key_type* src_keys = keys;                                                                                                         \
+        key_type* dst_keys = temp_keys;                                                                                                    \
+        u32* src_values = values;                                                                                                          \
+        u32* dst_values = temp_values;                                                                                                     \
+                                                                                                                                           \
+        for (u32 d = 0; d < digit_count; ++d)                                                                                              \
+        {                                                                                                                                  \
+            const u64* counts = hist + d * RADIX_BUCKETS;                                                                                  \
+            if (digit_is_uniform(counts, count))                                                                                           \
+                continue;                                                                                                                  \
+                                                                                                                                           \
+            u64 offsets[RADIX_BUCKETS];                                                                                                    \
+            u64 sum = 0;                                                                                                                   \
+            for (u32 b = 0; b < RADIX_BUCKETS; ++b)                                                                                        \
+            {                                                                                                                              \
+                offsets[b] = sum;                                                                                                          \
+                sum += counts[b];                                                                                                          \
+            }                                                                                                                              \
+            scatter_##suffix(src_keys, src_values, dst_keys, dst_values, 0, count, d * 8, offsets);                                        \
+                                                                                                                                           \
+            key_type* swap_keys = src_keys;                                                                                                \
+            src_keys = dst_keys;                                                                                                           \
+            dst_keys = swap_keys;                                                                                                          \
+            u32* swap_values = src_values;                                                                                                 \
+            src_values = dst_values;                                                                                                       \
+            dst_values = swap_values;                                                                                                      \
+        }                                                                                                                                  \
+                                                                                                                                           \
+        /* odd number of passes, the result sits in the scratch buffer. */                                                                 \
+        if (src_keys != keys)                                                                                                              \
+        {                                                                                                                                  \
+            ac_copy_memory_t(keys, src_keys, count * sizeof(key_type));                                                                    \
+            if (values)                                                                                                                    \
+                ac_copy_memory_t(values, src_values, count * sizeof(u32));                                                                 \
+        }                                                                                                                                  \
+                                                                                                                                           \
+        ac_free_t(temp_keys, count * sizeof(key_type), MEMTAG_ARRAY);                                                                      \
+        if (temp_values)                                                                                                                   \
+            ac_free_t(temp_values, count * sizeof(u32), MEMTAG_ARRAY);                                                                     \
+    }                                                                                                                                      \
+                                                                                                                                           \
+    static void radix_sort_worker_##suffix(void* param)                                                                                    \
+    {                                                                                                                                      \
+        radix_sort_mt_worker* worker = param;                                                                                              \
+        radix_sort_mt_state* state = worker->state;                                                                                        \
+        mt_wait_start(state);                                                                                                              \
+                                                                                                                                           \
+        u32 workers = state->worker_count;                                                                                                 \
+        u32 self = worker->index;                                                                                                          \
+        u64 count = state->count;                                                                                                          \
+        u64 begin = count * self / workers;                                                                                                \
+        u64 end = count * (self + 1) / workers;                                                                                            \
+        u64 all_stride = digit_count * RADIX_BUCKETS;                                                                                      \
+                                                                                                                                           \
+        key_type* src_keys = state->keys;                                                                                                  \
+        key_type* dst_keys = state->temp_keys;                                                                                             \
+        u32* src_values = state->values;                                                                                                   \
+        u32* dst_values = state->temp_values;                                                                                              \
+                                                                                                                                           \
+        u64* own_all = state->all_hist + self * all_stride;                                                                                \
+        ac_zero_memory_t(own_all, all_stride * sizeof(u64));                                                                               \
+        histogram_##suffix(src_keys, begin, end, own_all);                                                                                 \
+        sort_barrier_wait(&state->barrier);                                                                                                \
+                                                                                                                                           \
+        b8 first_pass = TRUE;                                                                                                              \
+        for (u32 d = 0; d < digit_count; ++d)                                                                                              \
+        {                                                                                                                                  \
+            /* the totals per byte do not change with the order, take them from the first count. */                                        \
+            u64 totals[RADIX_BUCKETS] = { 0 };                                                                                             \
+            for (u32 w = 0; w < workers; ++w)                                                                                              \
+            {                                                                                                                              \
+                const u64* counts = state->all_hist + w * all_stride + d * RADIX_BUCKETS;                                                  \
+                for (u32 b = 0; b < RADIX_BUCKETS; ++b)                                                                                    \
+                    totals[b] += counts[b];                                                                                                \
+            }                                                                                                                              \
+            if (digit_is_uniform(totals, count))                                                                                           \
+                continue;                                                                                                                  \
+                                                                                                                                           \
+            /* the chunks still hold the original keys on the first pass, later passes count again. */                                    \
+            const u64* chunk_hist = state->all_hist + d * RADIX_BUCKETS;                                                                   \
+            u64 chunk_stride = all_stride;                                                                                                 \
+            if (!first_pass)                                                                                                               \
+            {                                                                                                                              \
+                u64* own_pass = state->pass_hist + self * RADIX_BUCKETS;                                                                   \
+                ac_zero_memory_t(own_pass, RADIX_BUCKETS * sizeof(u64));                                                                   \
+                u32 shift = d * 8;                                                                                                         \
+                for (u64 i = begin; i < end; ++i)                                                                                          \
+                    own_pass[(src_keys[i] >> shift) & 0xFF]++;                                                                             \
+                sort_barrier_wait(&state->barrier);                                                                                        \
+                chunk_hist = state->pass_hist;                                                                                             \
+                chunk_stride = RADIX_BUCKETS;                                                                                              \
+            }                                                                                                                              \
+                                                                                                                                           \
+            /* bucket b of this chunk starts after all smaller buckets and after bucket b of the chunks before it. */                      \
+            u64 offsets[RADIX_BUCKETS];                                                                                                    \
+            u64 sum = 0;                                                                                                                   \
+            for (u32 b = 0; b < RADIX_BUCKETS; ++b)                                                                                        \
+            {                                                                                                                              \
+                u64 before = 0;                                                                                                            \
+                for (u32 w = 0; w < self; ++w)                                                                                             \
+                    before += chunk_hist[w * chunk_stride + b];                                                                            \
+                offsets[b] = sum + before;                                                                                                 \
+                sum += totals[b];                                                                                                          \
+            }                                                                                                                              \
+            scatter_##suffix(src_keys, src_values, dst_keys, dst_values, begin, end, d * 8, offsets);                                      \
+            sort_barrier_wait(&state->barrier);                                                                                            \
+                                                                                                                                           \
+            key_type* swap_keys = src_keys;                                                                                                \
+            src_keys = dst_keys;                                                                                                           \
+            dst_keys = swap_keys;                                                                                                          \
+            u32* swap_values = src_values;                                                                                                 \
+            src_values = dst_values;                                                                                                       \
+            dst_values = swap_values;                                                                                                      \
+            first_pass = FALSE;                                                                                                            \
+        }                                                                                                                                  \
+                                                                                                                                           \
+        if (src_keys != (key_type*)state->keys)                                                                                            \
+        {                                                                                                                                  \
+            ac_copy_memory_t((key_type*)state->keys + begin, src_keys + begin, (end - begin) * sizeof(key_type));                         \
+            if (src_values)                                                                                                                \
+                ac_copy_memory_t(state->values + begin, src_values + begin, (end - begin) * sizeof(u32));                                 \
+        }                                                                                                                                  \
+    }                                                                                                                                      \
+                                                                                                                                           \
+    static void radix_sort_mt_##suffix(key_type* keys, u32* values, u64 count, u32 thread_count)                                          \
+    {                                                                                                                                      \
+        u32 workers = radix_sort_mt_workers(count, thread_count);                                                                          \
+        if (workers <= 1)                                                                                                                  \
+        {                                                                                                                                  \
+            radix_sort_##suffix(keys, values, count);                                                                                      \
+            return;                                                                                                                        \
+        }                                                                                                                                  \
+                                                                                                                                           \
+        radix_sort_mt_state state = { 0 };                                                                                                 \
+        state.keys = keys;                                                                                                                 \
+        state.values = values;                                                                                                             \
+        state.count = count;                                                                                                               \
+        state.temp_keys = ac_allocate_uninit_t(count * sizeof(key_type), MEMTAG_ARRAY);                                                    \
+        state.temp_values = values ? ac_allocate_uninit_t(count * sizeof(u32), MEMTAG_ARRAY) : 0;                                          \
+        u64 hist_size = workers * (digit_count + 1) * RADIX_BUCKETS * sizeof(u64);                                                         \
+        state.all_hist = ac_allocate_aligned_t(hist_size, ACCACHE_LINE_SIZE, MEMTAG_ARRAY);                                                \
+        state.pass_hist = state.all_hist + workers * digit_count * RADIX_BUCKETS;                                                          \
+                                                                                                                                           \
+        radix_sort_mt_worker worker[RADIX_SORT_MT_MAX_THREADS];                                                                            \
+        u32 started = 1;                                                                                                                   \
+        for (; started < workers; ++started)                                                                                               \
+        {                                                                                                                                  \
+            worker[started].state = &state;                                                                                                \
+            worker[started].index = started;                                                                                               \
+            if (!platform_thread_create(radix_sort_worker_##suffix, &worker[started], &worker[started].thread))                            \
+                break;                                                                                                                     \
+        }                                                                                                                                  \
+        /* run with the threads that did start. */                                                                                         \
+        state.worker_count = started;                                                                                                      \
+        state.barrier.count = started;                                                                                                     \
+        __atomic_store_n(&state.start, 1, __ATOMIC_RELEASE);                                                                               \
+                                                                                                                                           \
+        worker[0].state = &state;                                                                                                          \
+        worker[0].index = 0;                                                                                                               \
+        radix_sort_worker_##suffix(&worker[0]);                                                                                            \
+        for (u32 i = 1; i < started; ++i)                                                                                                  \
+            platform_thread_join(&worker[i].thread);                                                                                       \
+                                                                                                                                           \
+        ac_free_aligned_t(state.all_hist, hist_size, ACCACHE_LINE_SIZE, MEMTAG_ARRAY);                                                     \
+        ac_free_t(state.temp_keys, count * sizeof(key_type), MEMTAG_ARRAY);                                                                \
+        if (state.temp_values)                                                                                                             \
+            ac_free_t(state.temp_values, count * sizeof(u32), MEMTAG_ARRAY);                                                               \
+    }
+
+static u32 radix_sort_mt_workers(u64 count, u32 thread_count)
+{
+    u32 workers = thread_count ? thread_count : platform_processor_count();
+    if (workers > RADIX_SORT_MT_MAX_THREADS)
+        workers = RADIX_SORT_MT_MAX_THREADS;
+    u64 by_size = count / RADIX_SORT_MT_MIN_CHUNK;
+    if (workers > by_size)
+        workers = by_size ? (u32)by_size : 1;
+    return workers;
+}
+
+RADIX_SORT_DEFINE(u32, u32, 4)
+RADIX_SORT_DEFINE(u64, u64, 8)
+
+void ac_radix_sort_u32_t(u32* keys, u32* values, u64 count) { radix_sort_u32(keys, values, count); }
+
+void ac_radix_sort_u64_t(u64* keys, u32* values, u64 count) { radix_sort_u64(keys, values, count); }
+
+void ac_radix_sort_u32_mt_t(u32* keys, u32* values, u64 count, u32 thread_count) { radix_sort_mt_u32(keys, values, count, thread_count); }
+
+void ac_radix_sort_u64_mt_t(u64* keys, u32* values, u64 count, u32 thread_count) { radix_sort_mt_u64(keys, values, count, thread_count); }
+
+// ------------------------ benchmark ------------------------
+
+typedef struct sort_pair_u32
+{
+    u32 key;
+    u32 value;
+} sort_pair_u32;
+
+typedef struct sort_pair_u64
+{
+    u64 key;
+    u32 value;
+} sort_pair_u64;
+
+static int compare_pair_u32(const void* a, const void* b)
+{
+    u32 ka = ((const sort_pair_u32*)a)->key;
+    u32 kb = ((const sort_pair_u32*)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+static int compare_pair_u64(const void* a, const void* b)
+{
+    u64 ka = ((const sort_pair_u64*)a)->key;
+    u64 kb = ((const sort_pair_u64*)b)->key;
+    return (ka > kb) - (ka < kb);
+}
+
+static u64 benchmark_random(u64* seed)
+{
+    // xorshift64*
+    u64 x = *seed;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *seed = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+// TRUE if keys ascend and every value still points at its key in the source.
+#define BENCHMARK_CHECK(keys, values, source, count, ok)                                                                                   \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        ok = TRUE;                                                                                                                         \
+        for (u64 i = 0; i < count; ++i)                                                                                                    \
+        {                                                                                                                                  \
+            if ((i && keys[i - 1] > keys[i]) || source[values[i]] != keys[i])                                                              \
+            {                                                                                                                              \
+                ok = FALSE;                                                                                                                \
+                break;                                                                                                                     \
+            }                                                                                                                              \
+        }                                                                                                                                  \
+    } while (0)
+
+#define BENCHMARK_RUN(key_type, pair_type, compare, sort_st, sort_mt, label)                                                               \
+    do                                                                                                                                     \
+    {                                                                                                                                      \
+        key_type* source = ac_allocate_uninit_t(count * sizeof(key_type), MEMTAG_ARRAY);                                                   \
+        key_type* keys = ac_allocate_uninit_t(count * sizeof(key_type), MEMTAG_ARRAY);                                                     \
+        u32* values = ac_allocate_uninit_t(count * sizeof(u32), MEMTAG_ARRAY);                                                             \
+        pair_type* pairs = ac_allocate_uninit_t(count * sizeof(pair_type), MEMTAG_ARRAY);                                                  \
+        for (u64 i = 0; i < count; ++i)                                                                                                    \
+            source[i] = (key_type)benchmark_random(&seed);                                                                                 \
+                                                                                                                                           \
+        for (u64 i = 0; i < count; ++i)                                                                                                    \
+        {                                                                                                                                  \
+            pairs[i].key = source[i];                                                                                                      \
+            pairs[i].value = (u32)i;                                                                                                       \
+        }                                                                                                                                  \
+        f64 start = platform_get_absolute_time();                                                                                          \
+        qsort(pairs, count, sizeof(pair_type), compare);                                                                                   \
+        f64 qsort_ms = (platform_get_absolute_time() - start) * 1000.0;                                                                    \
+                                                                                                                                           \
+        for (u64 i = 0; i < count; ++i)                                                                                                    \
+        {                                                                                                                                  \
+            keys[i] = source[i];                                                                                                           \
+            values[i] = (u32)i;                                                                                                            \
+        }                                                                                                                                  \
+        start = platform_get_absolute_time();                                                                                              \
+        sort_st(keys, values, count);                                                                                                      \
+        f64 radix_ms = (platform_get_absolute_time() - start) * 1000.0;                                                                    \
+        b8 radix_ok;                                                                                                                       \
+        BENCHMARK_CHECK(keys, values, source, count, radix_ok);                                                                            \
+                                                                                                                                           \
+        for (u64 i = 0; i < count; ++i)                                                                                                    \
+        {                                                                                                                                  \
+            keys[i] = source[i];                                                                                                           \
+            values[i] = (u32)i;                                                                                                            \
+        }                                                                                                                                  \
+        start = platform_get_absolute_time();                                                                                              \
+        sort_mt(keys, values, count, 0);                                                                                                   \
+        f64 radix_mt_ms = (platform_get_absolute_time() - start) * 1000.0;                                                                 \
+        b8 radix_mt_ok;                                                                                                                    \
+        BENCHMARK_CHECK(keys, values, source, count, radix_mt_ok);                                                                         \
+                                                                                                                                           \
+        ACINFO("sort %8llu %s keys: qsort %8.3f ms | radix %8.3f ms%s | radix mt (%u threads) %8.3f ms%s",                                 \
+               count,                                                                                                                      \
+               label,                                                                                                                      \
+               qsort_ms,                                                                                                                   \
+               radix_ms,                                                                                                                   \
+               radix_ok ? "" : " WRONG",                                                                                                   \
+               radix_sort_mt_workers(count, 0),                                                                                            \
+               radix_mt_ms,                                                                                                                \
+               radix_mt_ok ? "" : " WRONG");                                                                                               \
+                                                                                                                                           \
+        ac_free_t(source, count * sizeof(key_type), MEMTAG_ARRAY);                                                                         \
+        ac_free_t(keys, count * sizeof(key_type), MEMTAG_ARRAY);                                                                           \
+        ac_free_t(values, count * sizeof(u32), MEMTAG_ARRAY);                                                                              \
+        ac_free_t(pairs, count * sizeof(pair_type), MEMTAG_ARRAY);                                                                         \
+    } while (0)
+
+void ac_sort_benchmark_t()
+{
+    static const u64 counts[] = { 10000, 100000, 1000000 };
+    u64 seed = 0x9E3779B97F4A7C15ull;
+
+    for (u32 i = 0; i < sizeof(counts) / sizeof(counts[0]); ++i)
+    {
+        u64 count = counts[i];
+        BENCHMARK_RUN(u32, sort_pair_u32, compare_pair_u32, ac_radix_sort_u32_t, ac_radix_sort_u32_mt_t, "u32");
+        BENCHMARK_RUN(u64, sort_pair_u64, compare_pair_u64, ac_radix_sort_u64_t, ac_radix_sort_u64_mt_t, "u64");
+    }
+}
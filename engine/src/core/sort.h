@@ -0,0 +1,81 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * LSD radix sort on unsigned 32/64-bit keys, one byte (256 buckets) per pass.
+ * One read over the keys builds the histograms of every byte, a pass whose
+ * byte is the same for all keys is skipped, so e.g. keys that only use their
+ * low 20 bits take 3 passes instead of 4. Each pass is a stable scatter between
+ * the keys and a scratch buffer, values (payload indices) travel with their
+ * keys. O(n) with no compares, it beats qsort from a few hundred keys on.
+ * Below RADIX_SORT_SMALL_COUNT keys an insertion sort is used instead.
+ *
+ * The _mt_t variants split the keys in one chunk per worker. Per pass every
+ * worker counts its chunk, waits for the others, derives where its chunk goes
+ * from all the counts and scatters it, so the result is the same stable order
+ * as the single threaded sort.
+ *
+ * Build keys with the ac_sort_key_* helpers so that unsigned order is the order
+ * wanted, e.g. a draw call key:
+ *   u64 key = SORT_KEY_FIELD(pipeline, 48, 16) | SORT_KEY_FIELD(material, 32, 16) | ac_sort_key_f32_t(depth);
+ */
+
+#define RADIX_SORT_SMALL_COUNT 64
+// keys per worker below which the _mt_t variants use fewer threads.
+#define RADIX_SORT_MT_MIN_CHUNK (32 * 1024)
+#define RADIX_SORT_MT_MAX_THREADS 16
+
+/* INFO:
+ * Sorts keys ascending. values can be 0, else values[i] moves with keys[i].
+ * Allocates count keys + count values of scratch (MEMTAG_ARRAY) for the call.
+ */
+ACAPI void ac_radix_sort_u32_t(u32* keys, u32* values, u64 count);
+ACAPI void ac_radix_sort_u64_t(u64* keys, u32* values, u64 count);
+
+/* INFO:
+ * Same result as the single threaded versions, the calling thread works as one of the workers.
+ * thread_count: 0 picks the processor count. Capped at RADIX_SORT_MT_MAX_THREADS and lowered
+ *               so every worker gets at least RADIX_SORT_MT_MIN_CHUNK keys.
+ */
+ACAPI void ac_radix_sort_u32_mt_t(u32* keys, u32* values, u64 count, u32 thread_count);
+ACAPI void ac_radix_sort_u64_mt_t(u64* keys, u32* values, u64 count, u32 thread_count);
+
+/* INFO:
+ * Logs qsort against the radix sorts for 10k to 1M random u32 and u64 keys
+ * with payload indices. Allocates about 40MB while it runs.
+ */
+ACAPI void ac_sort_benchmark_t();
+
+// value masked to bits and moved up by shift.
+#define SORT_KEY_FIELD(value, shift, bits) (((u64)(value) & ((1ull << (bits)) - 1)) << (shift))
+
+// u32 whose unsigned order is the order of the floats (-inf .. +inf), NaNs sort past the infinities.
+static inline u32 ac_sort_key_f32_t(f32 value)
+{
+    union
+    {
+        f32 f;
+        u32 u;
+    } bits = { value };
+    // negative: flip every bit so larger magnitudes come first, positive: set the sign bit to go above them.
+    u32 mask = (u32)(-(i32)(bits.u >> 31)) | 0x80000000u;
+    return bits.u ^ mask;
+}
+
+// back-to-front order, e.g. transparent draws by depth.
+static inline u32 ac_sort_key_f32_descending_t(f32 value) { return ~ac_sort_key_f32_t(value); }
+
+static inline f32 ac_sort_key_to_f32_t(u32 key)
+{
+    u32 mask = (key >> 31) ? 0x80000000u : 0xFFFFFFFFu;
+    union
+    {
+        u32 u;
+        f32 f;
+    } bits = { key ^ mask };
+    return bits.f;
+}
+
+static inline u32 ac_sort_key_i32_t(i32 value) { return (u32)value ^ 0x80000000u; }
+static inline u64 ac_sort_key_i64_t(i64 value) { return (u64)value ^ 0x8000000000000000ull; }
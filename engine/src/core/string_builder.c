@@ -0,0 +1,724 @@
+#include "core/string_builder.h"
+#include "core/acmemory.h"
+#include "memory/linear_alloc.h"
+
+#include <stdarg.h>
+
+// enough for a u64 in octal (22 digits) or a f64 in fixed point below 1e19 with 18 decimals.
+#define NUMBER_TEXT_SIZE 48
+
+static const char digit_pairs[201] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+static const u64 power_of_ten[19] = { 1ull,
+                                      10ull,
+                                      100ull,
+                                      1000ull,
+                                      10000ull,
+                                      100000ull,
+                                      1000000ull,
+                                      10000000ull,
+                                      100000000ull,
+                                      1000000000ull,
+                                      10000000000ull,
+                                      100000000000ull,
+                                      1000000000000ull,
+                                      10000000000000ull,
+                                      100000000000000ull,
+                                      1000000000000000ull,
+                                      10000000000000000ull,
+                                      100000000000000000ull,
+                                      1000000000000000000ull };
+
+// ------------------------ number text ------------------------
+
+// writes value at out, returns the number of characters. out needs 20 bytes.
+static u32 u64_to_text(u64 value, char* out)
+{
+    char text[20];
+    char* cursor = text + sizeof(text);
+    while (value >= 100)
+    {
+        u64 pair = (value % 100) * 2;
+        value /= 100;
+        cursor -= 2;
+        cursor[0] = digit_pairs[pair];
+        cursor[1] = digit_pairs[pair + 1];
+    }
+    if (value >= 10)
+    {
+        cursor -= 2;
+        cursor[0] = digit_pairs[value * 2];
+        cursor[1] = digit_pairs[value * 2 + 1];
+    }
+    else
+        *--cursor = (char)('0' + value);
+
+    u32 length = (u32)(text + sizeof(text) - cursor);
+    ac_copy_memory_small_t(out, cursor, length);
+    return length;
+}
+
+// value in base 8 or 16 (shift 3 or 4).
+static u32 u64_to_text_pow2(u64 value, u32 shift, b8 upper, char* out)
+{
+    const char* digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char text[22];
+    char* cursor = text + sizeof(text);
+    u64 mask = (1ull << shift) - 1;
+    do
+    {
+        *--cursor = digits[value & mask];
+        value >>= shift;
+    } while (value);
+
+    u32 length = (u32)(text + sizeof(text) - cursor);
+    ac_copy_memory_small_t(out, cursor, length);
+    return length;
+}
+
+// value as exactly count digits, leading zeros kept.
+static void u64_to_text_fixed(u64 value, u32 count, char* out)
+{
+    for (u32 i = count; i > 0; --i)
+    {
+        out[i - 1] = (char)('0' + value % 10);
+        value /= 10;
+    }
+}
+
+// 10^(2^i), scales a double to [1, 10) in at most 9 steps.
+static const f64 binary_power_of_ten[9] = { 1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256 };
+
+// nan/inf text, returns 0 when value is finite.
+static u32 f64_special_text(f64 value, b8 upper, char* out)
+{
+    if (value != value)
+    {
+        ac_copy_memory_small_t(out, upper ? "NAN" : "nan", 3);
+        return 3;
+    }
+    if (value > 1.7976931348623157e308)
+    {
+        ac_copy_memory_small_t(out, upper ? "INF" : "inf", 3);
+        return 3;
+    }
+    return 0;
+}
+
+/* INFO:
+ * Rounds value >= 0 to precision + 1 significant digits (precision at most 18).
+ * Returns the digits as an integer d.ddd * 10^precision, out_exponent gets the base 10
+ * exponent of the first digit: 1234.5 with precision 2 -> 123 and 3.
+ */
+static u64 f64_decimal(f64 value, u32 precision, i32* out_exponent)
+{
+    *out_exponent = 0;
+    if (value == 0.0)
+        return 0;
+
+    // largest power of ten at or below value, found one bit of the exponent at a time.
+    i32 exponent = 0;
+    if (value >= 10.0)
+    {
+        for (i32 i = 8; i >= 0; --i)
+        {
+            if (value >= binary_power_of_ten[i])
+            {
+                value /= binary_power_of_ten[i];
+                exponent += 1 << i;
+            }
+        }
+    }
+    else if (value < 1.0)
+    {
+        for (i32 i = 8; i >= 0; --i)
+        {
+            if (value * binary_power_of_ten[i] < 10.0)
+            {
+                value *= binary_power_of_ten[i];
+                exponent -= 1 << i;
+            }
+        }
+    }
+
+    u64 scale = power_of_ten[precision];
+    u64 digits = (u64)(value * (f64)scale + 0.5);
+    if (digits >= scale * 10)
+    {
+        // rounding carried into a new digit, 9.99e+20 -> 1.00e+21.
+        digits /= 10;
+        exponent++;
+    }
+    *out_exponent = exponent;
+    return digits;
+}
+
+// |value| as d.ddde+XX, precision digits after the dot (at most 18), at least two exponent digits.
+static u32 f64_to_text_exponent(f64 value, u32 precision, b8 upper, char* out)
+{
+    u32 length = f64_special_text(value, upper, out);
+    if (length)
+        return length;
+    if (precision > 18)
+        precision = 18;
+
+    i32 exponent;
+    u64 digits = f64_decimal(value, precision, &exponent);
+    u64 scale = power_of_ten[precision];
+
+    out[length++] = (char)('0' + digits / scale);
+    if (precision)
+    {
+        out[length++] = '.';
+        u64_to_text_fixed(digits % scale, precision, out + length);
+        length += precision;
+    }
+    out[length++] = upper ? 'E' : 'e';
+    out[length++] = exponent < 0 ? '-' : '+';
+    u64 magnitude = (u64)(exponent < 0 ? -exponent : exponent);
+    if (magnitude < 10)
+        out[length++] = '0';
+    length += u64_to_text(magnitude, out + length);
+    return length;
+}
+
+// |value| in fixed point, or d.ddde+XX when it does not fit a u64. Returns the number of characters.
+static u32 f64_to_text(f64 value, u32 precision, b8 upper, char* out)
+{
+    u32 length = f64_special_text(value, upper, out);
+    if (length)
+        return length;
+    if (precision > 18)
+        precision = 18;
+    if (value >= 1.8e19)
+        return f64_to_text_exponent(value, precision, upper, out);
+
+    u64 whole = (u64)value;
+    u64 scale = power_of_ten[precision];
+    u64 fraction = (u64)((value - (f64)whole) * (f64)scale + 0.5);
+    if (fraction >= scale)
+    {
+        whole++;
+        fraction -= scale;
+    }
+
+    length = u64_to_text(whole, out);
+    if (precision)
+    {
+        out[length++] = '.';
+        u64_to_text_fixed(fraction, precision, out + length);
+        length += precision;
+    }
+    return length;
+}
+
+/* INFO:
+ * %g: precision significant digits (0 counts as 1). Exponent form when the exponent is
+ * below -4 or at least precision, fixed point otherwise, then the trailing zeros of the
+ * fraction are dropped.
+ */
+static u32 f64_to_text_general(f64 value, u32 precision, b8 upper, char* out)
+{
+    u32 length = f64_special_text(value, upper, out);
+    if (length)
+        return length;
+    if (precision == 0)
+        precision = 1;
+    if (precision > 19)
+        precision = 19;
+
+    i32 exponent;
+    u64 digits = f64_decimal(value, precision - 1, &exponent);
+    if (exponent < -4 || exponent >= (i32)precision)
+        length = f64_to_text_exponent(value, precision - 1, upper, out);
+    else if (exponent < 0)
+    {
+        // 0.000ddd, can need more than 18 decimals so the digits are written directly.
+        out[length++] = '0';
+        out[length++] = '.';
+        for (i32 i = exponent + 1; i < 0; ++i)
+            out[length++] = '0';
+        u64_to_text_fixed(digits, precision, out + length);
+        length += precision;
+    }
+    else
+        length = f64_to_text(value, (u32)((i32)precision - 1 - exponent), upper, out);
+
+    u32 dot = 0;
+    while (dot < length && out[dot] != '.')
+        ++dot;
+    if (dot == length)
+        return length;
+
+    u32 end = dot;
+    while (end < length && out[end] != 'e' && out[end] != 'E')
+        ++end;
+    u32 last = end;
+    while (out[last - 1] == '0')
+        --last;
+    if (last - 1 == dot)
+        --last;
+
+    // move the exponent, if any, over the dropped zeros.
+    for (u32 i = end; i < length; ++i)
+        out[last + i - end] = out[i];
+    return last + length - end;
+}
+
+// ------------------------ builder ------------------------
+
+// bytes that can be appended, up to needed. Grows into the linear allocator when there is one.
+static u64 builder_room(string_builder* builder, u64 needed)
+{
+    if (builder->length + needed + 1 <= builder->capacity)
+        return needed;
+
+    if (builder->alloc)
+    {
+        u64 capacity = builder->capacity * 2;
+        if (capacity < builder->length + needed + 1)
+            capacity = builder->length + needed + 1;
+        char* block = ac_linear_alloc_allocate_t(builder->alloc, capacity);
+        if (block)
+        {
+            if (builder->buffer)
+                ac_copy_memory_t(block, builder->buffer, builder->length + 1);
+            else
+                block[0] = 0;
+            builder->buffer = block;
+            builder->capacity = capacity;
+            return needed;
+        }
+    }
+
+    builder->truncated = TRUE;
+    return builder->capacity ? builder->capacity - 1 - builder->length : 0;
+}
+
+static void builder_repeat(string_builder* builder, char c, u64 count)
+{
+    count = builder_room(builder, count);
+    if (!count)
+        return;
+
+    ac_set_memory_t(builder->buffer + builder->length, c, count);
+    builder->length += count;
+    builder->buffer[builder->length] = 0;
+}
+
+void ac_string_builder_create_t(char* buffer, u64 capacity, string_builder* out_builder)
+{
+    if (!out_builder)
+        return;
+
+    out_builder->buffer = capacity ? buffer : 0;
+    out_builder->capacity = buffer ? capacity : 0;
+    out_builder->length = 0;
+    out_builder->alloc = 0;
+    out_builder->truncated = FALSE;
+    if (out_builder->capacity)
+        out_builder->buffer[0] = 0;
+}
+
+void ac_string_builder_create_alloc_t(struct linear_alloc* alloc, u64 initial_capacity, string_builder* out_builder)
+{
+    if (!out_builder)
+        return;
+
+    ac_string_builder_create_t(0, 0, out_builder);
+    out_builder->alloc = alloc;
+    if (initial_capacity)
+        builder_room(out_builder, initial_capacity - 1);
+}
+
+void ac_string_builder_clear_t(string_builder* builder)
+{
+    builder->length = 0;
+    builder->truncated = FALSE;
+    if (builder->capacity)
+        builder->buffer[0] = 0;
+}
+
+void ac_string_builder_append_n_t(string_builder* builder, const char* str, u64 length)
+{
+    length = builder_room(builder, length);
+    if (!length)
+        return;
+
+    ac_copy_memory_t(builder->buffer + builder->length, str, length);
+    builder->length += length;
+    builder->buffer[builder->length] = 0;
+}
+
+void ac_string_builder_append_t(string_builder* builder, const char* str)
+{
+    if (str)
+        ac_string_builder_append_n_t(builder, str, string_length(str));
+}
+
+void ac_string_builder_append_char_t(string_builder* builder, char c)
+{
+    if (!builder_room(builder, 1))
+        return;
+
+    builder->buffer[builder->length++] = c;
+    builder->buffer[builder->length] = 0;
+}
+
+void ac_string_builder_append_u64_t(string_builder* builder, u64 value)
+{
+    char text[NUMBER_TEXT_SIZE];
+    ac_string_builder_append_n_t(builder, text, u64_to_text(value, text));
+}
+
+void ac_string_builder_append_i64_t(string_builder* builder, i64 value)
+{
+    char text[NUMBER_TEXT_SIZE];
+    u32 length = 0;
+    if (value < 0)
+        text[length++] = '-';
+    // negate as unsigned so i64 min does not overflow.
+    u64 magnitude = value < 0 ? 0 - (u64)value : (u64)value;
+    length += u64_to_text(magnitude, text + length);
+    ac_string_builder_append_n_t(builder, text, length);
+}
+
+void ac_string_builder_append_hex_t(string_builder* builder, u64 value)
+{
+    char text[NUMBER_TEXT_SIZE];
+    ac_string_builder_append_n_t(builder, text, u64_to_text_pow2(value, 4, FALSE, text));
+}
+
+void ac_string_builder_append_f64_t(string_builder* builder, f64 value, u32 precision)
+{
+    char text[NUMBER_TEXT_SIZE];
+    u32 length = 0;
+    if (value < 0)
+    {
+        text[length++] = '-';
+        value = -value;
+    }
+    length += f64_to_text(value, precision, FALSE, text + length);
+    ac_string_builder_append_n_t(builder, text, length);
+}
+
+void ac_string_builder_format_t(string_builder* builder, const char* format, ...)
+{
+    __builtin_va_list arg_ptr;
+    va_start(arg_ptr, format);
+    ac_string_builder_vformat_t(builder, format, arg_ptr);
+    va_end(arg_ptr);
+}
+
+// ------------------------ format ------------------------
+
+typedef struct format_spec
+{
+    b8 left;
+    b8 zero;
+    b8 plus;
+    b8 space;
+    b8 has_precision;
+    u32 width;
+    u32 precision;
+} format_spec;
+
+// prefix (sign, 0x) + body padded to spec->width.
+static void format_emit(string_builder* builder, const format_spec* spec, const char* prefix, u32 prefix_length, const char* body, u64 body_length)
+{
+    u64 total = prefix_length + body_length;
+    u64 pad = spec->width > total ? spec->width - total : 0;
+
+    if (pad && !spec->left && !spec->zero)
+        builder_repeat(builder, ' ', pad);
+    ac_string_builder_append_n_t(builder, prefix, prefix_length);
+    if (pad && !spec->left && spec->zero)
+        builder_repeat(builder, '0', pad);
+    ac_string_builder_append_n_t(builder, body, body_length);
+    if (pad && spec->left)
+        builder_repeat(builder, ' ', pad);
+}
+
+// integer digits with the precision as minimum digit count.
+static void format_integer(string_builder* builder, format_spec* spec, const char* prefix, u32 prefix_length, const char* digits, u32 length)
+{
+    char text[NUMBER_TEXT_SIZE + 32];
+    u32 zeros = 0;
+    if (spec->has_precision)
+    {
+        // an explicit precision turns off the 0 flag, %.0d of 0 prints nothing.
+        spec->zero = FALSE;
+        if (spec->precision == 0 && length == 1 && digits[0] == '0')
+            length = 0;
+        zeros = spec->precision > length ? spec->precision - length : 0;
+        if (zeros > 32)
+            zeros = 32;
+    }
+    ac_set_memory_t(text, '0', zeros);
+    ac_copy_memory_small_t(text + zeros, digits, length);
+    format_emit(builder, spec, prefix, prefix_length, text, zeros + length);
+}
+
+void ac_string_builder_vformat_t(string_builder* builder, const char* format, __builtin_va_list args)
+{
+    if (!builder || !format)
+        return;
+
+    const char* cursor = format;
+    while (*cursor)
+    {
+        // copy the literal run up to the next conversion in one go.
+        const char* run = cursor;
+        while (*cursor && *cursor != '%')
+            ++cursor;
+        if (cursor != run)
+            ac_string_builder_append_n_t(builder, run, (u64)(cursor - run));
+        if (!*cursor)
+            break;
+
+        const char* spec_start = cursor++;
+        format_spec spec = { 0 };
+        // cleared for specs that can't be written like libc would, those are copied as is.
+        b8 honoured = TRUE;
+        for (;; ++cursor)
+        {
+            if (*cursor == '-')
+                spec.left = TRUE;
+            else if (*cursor == '0')
+                spec.zero = TRUE;
+            else if (*cursor == '+')
+                spec.plus = TRUE;
+            else if (*cursor == ' ')
+                spec.space = TRUE;
+            else if (*cursor == '#')
+                honoured = FALSE;
+            else
+                break;
+        }
+
+        if (*cursor == '*')
+        {
+            i32 width = va_arg(args, i32);
+            if (width < 0)
+            {
+                spec.left = TRUE;
+                width = -width;
+            }
+            spec.width = (u32)width;
+            ++cursor;
+        }
+        else
+        {
+            while (*cursor >= '0' && *cursor <= '9')
+                spec.width = spec.width * 10 + (u32)(*cursor++ - '0');
+        }
+
+        if (*cursor == '.')
+        {
+            spec.has_precision = TRUE;
+            ++cursor;
+            if (*cursor == '*')
+            {
+                i32 precision = va_arg(args, i32);
+                spec.has_precision = precision >= 0;
+                spec.precision = precision >= 0 ? (u32)precision : 0;
+                ++cursor;
+            }
+            else
+            {
+                while (*cursor >= '0' && *cursor <= '9')
+                    spec.precision = spec.precision * 10 + (u32)(*cursor++ - '0');
+            }
+        }
+        if (spec.left)
+            spec.zero = FALSE;
+
+        // 0: int, 1: long, 2: long long, 3: size_t, 4: long double, -1: short, -2: char.
+        i32 size = 0;
+        if (*cursor == 'h')
+        {
+            size = cursor[1] == 'h' ? -2 : -1;
+            cursor -= size;
+        }
+        else if (*cursor == 'l')
+        {
+            size = cursor[1] == 'l' ? 2 : 1;
+            cursor += size;
+        }
+        else if (*cursor == 'z')
+        {
+            size = 3;
+            ++cursor;
+        }
+        else if (*cursor == 'j')
+        {
+            size = 2;
+            ++cursor;
+        }
+        else if (*cursor == 'L')
+        {
+            // the argument is still read as a long double so the ones after it stay in place.
+            size = 4;
+            honoured = FALSE;
+            ++cursor;
+        }
+
+        char conversion = *cursor;
+        if (conversion)
+            ++cursor;
+
+        char text[NUMBER_TEXT_SIZE];
+        switch (conversion)
+        {
+        case 'd':
+        case 'i':
+        {
+            i64 value;
+            if (size == 1)
+                value = va_arg(args, long);
+            else if (size == 2 || size == 4)
+                value = va_arg(args, long long);
+            else if (size == 3)
+                value = (i64)va_arg(args, __SIZE_TYPE__);
+            else
+                value = va_arg(args, i32);
+            if (size == -1)
+                value = (i16)value;
+            else if (size == -2)
+                value = (i8)value;
+            if (!honoured)
+                break;
+
+            char sign = value < 0 ? '-' : spec.plus ? '+' : spec.space ? ' ' : 0;
+            u64 magnitude = value < 0 ? 0 - (u64)value : (u64)value;
+            u32 length = u64_to_text(magnitude, text);
+            format_integer(builder, &spec, &sign, sign ? 1 : 0, text, length);
+        }
+        break;
+        case 'u':
+        case 'x':
+        case 'X':
+        case 'o':
+        {
+            u64 value;
+            if (size == 1)
+                value = va_arg(args, unsigned long);
+            else if (size == 2 || size == 4)
+                value = va_arg(args, unsigned long long);
+            else if (size == 3)
+                value = va_arg(args, __SIZE_TYPE__);
+            else
+                value = va_arg(args, u32);
+            if (size == -1)
+                value = (u16)value;
+            else if (size == -2)
+                value = (u8)value;
+            if (!honoured)
+                break;
+
+            u32 length;
+            if (conversion == 'u')
+                length = u64_to_text(value, text);
+            else if (conversion == 'o')
+                length = u64_to_text_pow2(value, 3, FALSE, text);
+            else
+                length = u64_to_text_pow2(value, 4, conversion == 'X', text);
+            format_integer(builder, &spec, 0, 0, text, length);
+        }
+        break;
+        case 'p':
+        {
+            u64 value = (u64)va_arg(args, void*);
+            if (!honoured)
+                break;
+            u32 length = u64_to_text_pow2(value, 4, FALSE, text);
+            format_integer(builder, &spec, "0x", 2, text, length);
+        }
+        break;
+        case 'c':
+        {
+            char c = (char)va_arg(args, i32);
+            if (!honoured)
+                break;
+            spec.zero = FALSE;
+            format_emit(builder, &spec, 0, 0, &c, 1);
+        }
+        break;
+        case 's':
+        {
+            const char* str = va_arg(args, const char*);
+            if (!honoured)
+                break;
+            if (!str)
+                str = "(null)";
+            // with a precision the string does not have to be null terminated.
+            u64 length = 0;
+            if (spec.has_precision)
+                while (length < spec.precision && str[length])
+                    ++length;
+            else
+                length = string_length(str);
+            spec.zero = FALSE;
+            format_emit(builder, &spec, 0, 0, str, length);
+        }
+        break;
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        {
+            if (size == 4)
+            {
+                (void)va_arg(args, long double);
+                break;
+            }
+            f64 value = va_arg(args, f64);
+            u32 precision = spec.has_precision ? spec.precision : 6;
+            // past these the digits would be capped, not what was asked for.
+            if (precision > (conversion == 'g' || conversion == 'G' ? 19u : 18u))
+                honoured = FALSE;
+            if (!honoured)
+                break;
+            b8 upper = conversion == 'F' || conversion == 'E' || conversion == 'G';
+
+            // signbit so -0.0 keeps its sign, like libc.
+            char sign = __builtin_signbit(value) ? '-' : spec.plus ? '+' : spec.space ? ' ' : 0;
+            value = __builtin_fabs(value);
+            u32 length;
+            if (conversion == 'e' || conversion == 'E')
+                length = f64_to_text_exponent(value, precision, upper, text);
+            else if (conversion == 'g' || conversion == 'G')
+                length = f64_to_text_general(value, precision, upper, text);
+            else
+                length = f64_to_text(value, precision, upper, text);
+
+            if (value != value || value > 1.7976931348623157e308)
+                spec.zero = FALSE;
+            format_emit(builder, &spec, &sign, sign ? 1 : 0, text, length);
+        }
+        break;
+        case '%':
+            if (honoured)
+                ac_string_builder_append_char_t(builder, '%');
+            break;
+        default:
+            honoured = FALSE;
+            break;
+        }
+
+        // not a conversion we know or can honour, keep the text as written.
+        if (!honoured)
+            ac_string_builder_append_n_t(builder, spec_start, (u64)(cursor - spec_start));
+    }
+}
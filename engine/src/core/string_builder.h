@@ -0,0 +1,67 @@
+#pragma once
+
+#include "define.h"
+#include "core/astring.h"
+
+struct linear_alloc;
+
+/* PERF:
+ * Appends text into memory the caller already has: a fixed buffer (stack,
+ * struct member) or a linear allocator such as the frame allocator. Nothing
+ * goes through the heap, so it is safe inside the logger and the allocator.
+ * Numbers are formatted with a two-digits-per-step table and floats without
+ * libc, no locale lookups and no per call buffers.
+ * +-------------------------------+----+--------------------+
+ * | text (length)                 | \0 | free               |
+ * +-------------------------------+----+--------------------+
+ * ^ buffer                                                  ^ buffer + capacity
+ * Fixed buffer: appends that do not fit are cut and truncated is set.
+ * Linear alloc: a full builder moves to a block twice the size in the same
+ * allocator, the old block is given back with the allocator's next reset.
+ */
+
+typedef struct string_builder
+{
+    char* buffer;
+    u64 capacity; // including the null terminator.
+    u64 length;
+    struct linear_alloc* alloc; // 0 for a fixed buffer.
+    b8 truncated;
+} string_builder;
+
+// buffer must hold at least 1 byte, it is always kept null terminated.
+ACAPI void ac_string_builder_create_t(char* buffer, u64 capacity, string_builder* out_builder);
+ACAPI void ac_string_builder_create_alloc_t(struct linear_alloc* alloc, u64 initial_capacity, string_builder* out_builder);
+
+ACAPI void ac_string_builder_clear_t(string_builder* builder);
+
+ACAPI void ac_string_builder_append_t(string_builder* builder, const char* str);
+ACAPI void ac_string_builder_append_n_t(string_builder* builder, const char* str, u64 length);
+ACAPI void ac_string_builder_append_char_t(string_builder* builder, char c);
+ACAPI void ac_string_builder_append_u64_t(string_builder* builder, u64 value);
+ACAPI void ac_string_builder_append_i64_t(string_builder* builder, i64 value);
+ACAPI void ac_string_builder_append_hex_t(string_builder* builder, u64 value);
+// fixed point with precision digits after the dot (at most 18), rounded half up.
+ACAPI void ac_string_builder_append_f64_t(string_builder* builder, f64 value, u32 precision);
+
+static inline void ac_string_builder_append_view_t(string_builder* builder, string_view view)
+{
+    ac_string_builder_append_n_t(builder, view.str, view.length);
+}
+
+/* INFO:
+ * printf style formatting without libc.
+ * Supports the flags - 0 + space, width and precision (number or *), the length
+ * modifiers hh h l ll z j and the conversions d i u x X o c s p f F e E g G %.
+ * Specs it can't honour are copied as is (their argument is still consumed): unknown
+ * conversions, the # flag, L and a float precision above 18 (above 19 for %g).
+ * Floats round half up (2.5 -> 3 with %.0f), libc rounds exact halves to even. Digits past
+ * the 17th significant one are not exact, %f of values from 1.8e19 up is written as %e.
+ */
+ACAPI void ac_string_builder_format_t(string_builder* builder, const char* format, ...);
+ACAPI void ac_string_builder_vformat_t(string_builder* builder, const char* format, __builtin_va_list args);
+
+static inline string_view ac_string_builder_view_t(const string_builder* builder)
+{
+    return string_view_create_n(builder->buffer, builder->length);
+}
@@ -0,0 +1,141 @@
+#include "core/string_id.h"
+#include "container/hashmap.h"
+#include "core/logger.h"
+#include "memory/vmem_arena.h"
+
+#include <string.h>
+
+typedef struct interned_string
+{
+    const char* str;
+    u64 length;
+} interned_string;
+
+typedef struct string_table_state
+{
+    vmem_arena arena;
+    hashmap ids; // string_id -> interned_string
+    u8 lock;
+} string_table_state;
+
+static b8 initialized = FALSE;
+static string_table_state state;
+
+#define STRING_TABLE_DEF_CAPACITY 256
+
+static void table_lock()
+{
+    while (__atomic_test_and_set(&state.lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void table_unlock() { __atomic_clear(&state.lock, __ATOMIC_RELEASE); }
+
+// the key already is a hash, use it as is.
+static u64 id_hash(const void* key, u64 key_stride) { return *(const string_id*)key; }
+
+b8 string_table_initialize()
+{
+    if (initialized)
+        return FALSE;
+
+    if (!ac_vmem_arena_create_t("string_table", STRING_TABLE_RESERVE_SIZE, MEMTAG_STRING, FALSE, &state.arena))
+    {
+        ACERROR("string_table_initialize - failed to reserve %llu bytes.", (u64)STRING_TABLE_RESERVE_SIZE);
+        return FALSE;
+    }
+    ac_hashmap_create_t(sizeof(string_id), sizeof(interned_string), STRING_TABLE_DEF_CAPACITY, id_hash, 0, &state.ids);
+    state.lock = 0;
+
+    initialized = TRUE;
+    return TRUE;
+}
+
+void string_table_shutdown()
+{
+    if (!initialized)
+        return;
+
+    ac_hashmap_destroy_t(&state.ids);
+    ac_vmem_arena_destroy_t(&state.arena);
+    initialized = FALSE;
+}
+
+string_id ac_string_id_hash_t(const char* str, u64 length)
+{
+    const u8* bytes = (const u8*)str;
+    u64 hash = STRING_ID_FNV_OFFSET;
+    for (u64 i = 0; i < length; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= STRING_ID_FNV_PRIME;
+    }
+    return hash;
+}
+
+string_id ac_string_intern_t(const char* str)
+{
+    if (!str)
+        return STRING_ID_NONE;
+    return ac_string_intern_n_t(str, strlen(str));
+}
+
+string_id ac_string_intern_n_t(const char* str, u64 length)
+{
+    if (!str)
+        return STRING_ID_NONE;
+
+    string_id id = ac_string_id_hash_t(str, length);
+    if (!initialized)
+        return id;
+
+    table_lock();
+    interned_string* found = ac_hashmap_find_t(&state.ids, &id);
+    if (found)
+    {
+        if (found->length != length || memcmp(found->str, str, length) != 0)
+            ACERROR("ac_string_intern_t - '%.*s' and '%s' share id %llu.", (int)length, str, found->str, id);
+        table_unlock();
+        return id;
+    }
+
+    char* copy = ac_vmem_arena_allocate_t(&state.arena, length + 1);
+    if (!copy)
+    {
+        table_unlock();
+        ACERROR("ac_string_intern_t - string table is full (%llu bytes).", state.arena.reserved);
+        return id;
+    }
+    ac_copy_memory_t(copy, str, length);
+    copy[length] = 0;
+
+    interned_string entry = { copy, length };
+    ac_hashmap_insert_t(&state.ids, &id, &entry);
+    table_unlock();
+    return id;
+}
+
+const char* ac_string_id_str_t(string_id id)
+{
+    if (!initialized)
+        return 0;
+
+    table_lock();
+    interned_string* found = ac_hashmap_find_t(&state.ids, &id);
+    const char* str = found ? found->str : 0;
+    table_unlock();
+    return str;
+}
+
+u64 ac_string_id_length_t(string_id id)
+{
+    if (!initialized)
+        return 0;
+
+    table_lock();
+    interned_string* found = ac_hashmap_find_t(&state.ids, &id);
+    u64 length = found ? found->length : 0;
+    table_unlock();
+    return length;
+}
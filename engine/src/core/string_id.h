@@ -0,0 +1,67 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Interned strings. A string_id is the 64-bit FNV-1a hash of the string's
+ * bytes, so comparing two names is one integer compare instead of a strcmp,
+ * and the id of a literal is folded by the compiler with STRING_ID("...").
+ * The table keeps one copy of every interned string (id -> bytes) so an id
+ * can be turned back into text for logs and tools. All interned bytes live in
+ * one virtual memory arena (MEMTAG_STRING), pointers to them never move and
+ * stay valid until string_table_shutdown.
+ * Two different strings hashing to the same id is reported as an error when
+ * the second one is interned.
+ */
+
+typedef u64 string_id;
+
+#define STRING_ID_NONE 0
+#define STRING_ID_FNV_OFFSET 0xCBF29CE484222325ull
+#define STRING_ID_FNV_PRIME 0x100000001B3ull
+// longest literal STRING_ID accepts, longer ones fail to compile.
+#define STRING_ID_MAX_LITERAL 64
+// address space reserved for interned bytes, committed as it fills.
+#define STRING_TABLE_RESERVE_SIZE (64 * 1024 * 1024)
+
+b8 string_table_initialize();
+void string_table_shutdown();
+
+// FNV-1a over length bytes, same value STRING_ID gives for a literal. Works before initialize.
+ACAPI string_id ac_string_id_hash_t(const char* str, u64 length);
+
+/* INFO:
+ * Interns str (or its first length bytes) and returns its id. Interning the same
+ * string again only looks it up. Thread-safe.
+ * Before string_table_initialize it only hashes, the id still compares equal.
+ */
+ACAPI string_id ac_string_intern_t(const char* str);
+ACAPI string_id ac_string_intern_n_t(const char* str, u64 length);
+
+// Returns: The interned, null terminated bytes of id, or 0 if id was never interned.
+ACAPI const char* ac_string_id_str_t(string_id id);
+// Returns: Length of the interned string, 0 if id was never interned.
+ACAPI u64 ac_string_id_length_t(string_id id);
+
+// 32-bit id for tight structs, fold of the 64-bit one. Collisions get likely past ~10k strings.
+static inline u32 ac_string_id32_t(string_id id) { return (u32)(id ^ (id >> 32)); }
+
+/* INFO:
+ * Compile-time id of a string literal: STRING_ID("VK_LAYER_KHRONOS_validation").
+ * Folds to a constant, usable in static initializers but not as a case label.
+ * One FNV-1a step per character. Steps past the end xor 0 and multiply by 1,
+ * so the running hash appears once per step and the expansion stays linear.
+ */
+#define STRING_ID_CHAR(s, i) ((i) < sizeof(s) - 1 ? (u64)(u8)(s)[(i) < sizeof(s) ? (i) : 0] : 0ull)
+#define STRING_ID_STEP(s, i, x) (((x) ^ STRING_ID_CHAR(s, i)) * ((i) < sizeof(s) - 1 ? STRING_ID_FNV_PRIME : 1ull))
+#define STRING_ID_STEP4(s, i, x) STRING_ID_STEP(s, (i) + 3, STRING_ID_STEP(s, (i) + 2, STRING_ID_STEP(s, (i) + 1, STRING_ID_STEP(s, i, x))))
+#define STRING_ID_STEP16(s, i, x)                                                                                                          \
+    STRING_ID_STEP4(s, (i) + 12, STRING_ID_STEP4(s, (i) + 8, STRING_ID_STEP4(s, (i) + 4, STRING_ID_STEP4(s, i, x))))
+#define STRING_ID_STEP64(s, x)                                                                                                             \
+    STRING_ID_STEP16(s, 48, STRING_ID_STEP16(s, 32, STRING_ID_STEP16(s, 16, STRING_ID_STEP16(s, 0, x))))
+
+#define STRING_ID(literal)                                                                                                                 \
+    ((string_id)STRING_ID_STEP64("" literal, STRING_ID_FNV_OFFSET) +                                                                       \
+     0 * sizeof(char[sizeof(literal) <= STRING_ID_MAX_LITERAL + 1 ? 1 : -1]))
+
+#define STRING_ID32(literal) ((u32)(STRING_ID(literal) ^ (STRING_ID(literal) >> 32)))
@@ -102,4 +102,15 @@ STATIC_ASSERT(sizeof(f64) == 8, "Expected f64 to be 8 bytes.");
 
 #endif
 
+// Thread local storage and explicit alignment.
+#ifdef _MSC_VER
+#define ACTHREAD_LOCAL __declspec(thread)
+#define ACALIGN(n) __declspec(align(n))
+#else
+#define ACTHREAD_LOCAL __thread
+#define ACALIGN(n) __attribute__((aligned(n)))
+#endif
+
+#define ACCACHE_LINE_SIZE 64
+
 #define ACCLAMP(value, min, max) (value <= min) ? min : (value >= max) ? max : value
@@ -9,7 +9,7 @@ extern b8 create_game(game* out_game);
 
 int main(void)
 {
-    memory_initialize();
+    memory_initialize(ACMEMORY_HEAP_BUDGET);
 
     game game_inst;
     if (!create_game(&game_inst))
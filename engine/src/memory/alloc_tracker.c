@@ -0,0 +1,298 @@
+#include "memory/alloc_tracker.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if ACMEMORY_TRACKING
+
+typedef struct alloc_record
+{
+    void* block;
+    u64 size;
+    u64 sequence;
+    const char* file;
+    u32 line;
+    mem_tag tag;
+} alloc_record;
+
+typedef struct alloc_tracker_state
+{
+    alloc_record* records;
+    u64 capacity; // always power of two
+    u64 count;
+    u64 sequence;
+    u64 untracked; // blocks alive that could not be added, the table failed to grow.
+    b8 lock;
+} alloc_tracker_state;
+
+#define ALLOC_TRACKER_DEF_CAPACITY 1024
+
+static alloc_tracker_state tracker;
+
+static void tracker_lock()
+{
+    while (__atomic_test_and_set(&tracker.lock, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+static void tracker_unlock()
+{
+    __atomic_clear(&tracker.lock, __ATOMIC_RELEASE);
+}
+
+static u64 hash_address(void* block)
+{
+    // fibonacci hashing, low bits of an address are mostly alignment.
+    return ((u64)block >> 4) * 11400714819323198485ull;
+}
+
+static void tracker_insert(alloc_record* records, u64 capacity, const alloc_record* record)
+{
+    u64 mask = capacity - 1;
+    u64 index = hash_address(record->block) & mask;
+    while (records[index].block)
+        index = (index + 1) & mask;
+
+    records[index] = *record;
+}
+
+static b8 tracker_grow()
+{
+    u64 new_capacity = tracker.capacity ? tracker.capacity * 2 : ALLOC_TRACKER_DEF_CAPACITY;
+    alloc_record* new_records = platform_allocated(sizeof(alloc_record) * new_capacity, FALSE);
+    if (!new_records)
+        return FALSE;
+    platform_zero_mem(new_records, sizeof(alloc_record) * new_capacity);
+
+    for (u64 i = 0; i < tracker.capacity; ++i)
+    {
+        if (tracker.records[i].block)
+            tracker_insert(new_records, new_capacity, &tracker.records[i]);
+    }
+
+    if (tracker.records)
+        platform_free(tracker.records, FALSE);
+
+    tracker.records = new_records;
+    tracker.capacity = new_capacity;
+    return TRUE;
+}
+
+static i64 tracker_find(void* block)
+{
+    if (!tracker.records)
+        return -1;
+
+    u64 mask = tracker.capacity - 1;
+    u64 index = hash_address(block) & mask;
+    while (tracker.records[index].block)
+    {
+        if (tracker.records[index].block == block)
+            return (i64)index;
+        index = (index + 1) & mask;
+    }
+    return -1;
+}
+
+static void tracker_erase(u64 index)
+{
+    // backward shift: pull later entries of the probe chain into the hole.
+    u64 mask = tracker.capacity - 1;
+    u64 hole = index;
+    u64 next = (hole + 1) & mask;
+    while (tracker.records[next].block)
+    {
+        u64 home = hash_address(tracker.records[next].block) & mask;
+        // move the entry when its home is not inside (hole, next].
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            tracker.records[hole] = tracker.records[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    platform_zero_mem(&tracker.records[hole], sizeof(alloc_record));
+}
+
+static i32 compare_call_site(const void* a, const void* b)
+{
+    const alloc_record* ra = a;
+    const alloc_record* rb = b;
+    const char* fa = ra->file ? ra->file : "";
+    const char* fb = rb->file ? rb->file : "";
+    i32 result = strcmp(fa, fb);
+    if (result != 0)
+        return result;
+    return (i32)ra->line - (i32)rb->line;
+}
+
+// logs live blocks with sequence > since, grouped by call site. caller holds the lock.
+static u64 tracker_report(u64 since, const char* title)
+{
+    u64 found = 0;
+    for (u64 i = 0; i < tracker.capacity; ++i)
+    {
+        if (tracker.records[i].block && tracker.records[i].sequence > since)
+            found++;
+    }
+    if (found == 0)
+        return 0;
+
+    alloc_record* sorted = platform_allocated(sizeof(alloc_record) * found, FALSE);
+    u64 count = 0;
+    u64 total_size = 0;
+    for (u64 i = 0; i < tracker.capacity; ++i)
+    {
+        if (tracker.records[i].block && tracker.records[i].sequence > since)
+        {
+            sorted[count++] = tracker.records[i];
+            total_size += tracker.records[i].size;
+        }
+    }
+    qsort(sorted, count, sizeof(alloc_record), compare_call_site);
+
+    ACWARN("%s: %llu blocks, %lluB", title, count, total_size);
+    u64 start = 0;
+    while (start < count)
+    {
+        u64 end = start;
+        u64 group_size = 0;
+        while (end < count && compare_call_site(&sorted[start], &sorted[end]) == 0)
+        {
+            group_size += sorted[end].size;
+            end++;
+        }
+
+        ACWARN("  %s:%u - %llu blocks, %lluB (%s)",
+               sorted[start].file ? sorted[start].file : "<unknown call site>",
+               sorted[start].line,
+               end - start,
+               group_size,
+               ac_memory_tag_name_t(sorted[start].tag));
+        start = end;
+    }
+
+    platform_free(sorted, FALSE);
+    return count;
+}
+
+void alloc_tracker_initialize()
+{
+    platform_zero_mem(&tracker, sizeof(tracker));
+}
+
+void alloc_tracker_shutdown()
+{
+    tracker_lock();
+    if (tracker_report(0, "Memory leaks at shutdown") == 0)
+        ACINFO("No memory leaks detected.");
+
+    if (tracker.records)
+        platform_free(tracker.records, FALSE);
+    tracker.records = 0;
+    tracker.capacity = 0;
+    tracker.count = 0;
+    tracker_unlock();
+}
+
+void alloc_tracker_add(void* block, u64 size, mem_tag tag, const char* file, u32 line)
+{
+    if (!block)
+        return;
+
+    tracker_lock();
+    // keep load under 70%.
+    if ((tracker.count + 1) * 10 > tracker.capacity * 7 && !tracker_grow())
+    {
+        tracker.untracked++;
+        tracker_unlock();
+        ACWARN("Allocation tracker is full, %p (%s:%u) is not tracked.", block, file ? file : "<unknown call site>", line);
+        return;
+    }
+
+    alloc_record record;
+    record.block = block;
+    record.size = size;
+    record.sequence = ++tracker.sequence;
+    record.file = file;
+    record.line = line;
+    record.tag = tag;
+    tracker_insert(tracker.records, tracker.capacity, &record);
+    tracker.count++;
+    tracker_unlock();
+}
+
+b8 alloc_tracker_remove(void* block, u64 size, mem_tag tag)
+{
+    if (!block)
+        return TRUE;
+
+    tracker_lock();
+    i64 index = tracker_find(block);
+    if (index < 0)
+    {
+        // with untracked blocks alive this may be one of them, it still has to be freed.
+        b8 untracked = tracker.untracked > 0;
+        if (untracked)
+            tracker.untracked--;
+        tracker_unlock();
+        if (untracked)
+        {
+            ACWARN("Freeing %p which the tracker does not know, assuming an untracked block.", block);
+        }
+        else
+        {
+            ACWARN("Freeing %p which is not a live engine allocation (double free?).", block);
+        }
+        return untracked;
+    }
+
+    alloc_record* record = &tracker.records[index];
+    if (record->size != size || record->tag != tag)
+    {
+        ACWARN("Free of %p does not match its allocation at %s:%u: size %llu/%llu, tag %s/%s.",
+               block,
+               record->file ? record->file : "<unknown call site>",
+               record->line,
+               size,
+               record->size,
+               ac_memory_tag_name_t(tag),
+               ac_memory_tag_name_t(record->tag));
+    }
+
+    tracker_erase((u64)index);
+    tracker.count--;
+    tracker_unlock();
+    return TRUE;
+}
+
+void ac_memory_snapshot_t(memory_snapshot* out_snapshot)
+{
+    out_snapshot->sequence = __atomic_load_n(&tracker.sequence, __ATOMIC_RELAXED);
+}
+
+u64 ac_memory_snapshot_diff_t(const memory_snapshot* snapshot)
+{
+    tracker_lock();
+    u64 count = tracker_report(snapshot->sequence, "Blocks allocated since snapshot and still alive");
+    tracker_unlock();
+    return count;
+}
+
+#else
+
+void ac_memory_snapshot_t(memory_snapshot* out_snapshot)
+{
+    out_snapshot->sequence = 0;
+}
+
+u64 ac_memory_snapshot_diff_t(const memory_snapshot* snapshot)
+{
+    return 0;
+}
+
+#endif // ACMEMORY_TRACKING
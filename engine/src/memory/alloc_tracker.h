@@ -0,0 +1,48 @@
+#pragma once
+
+#include "define.h"
+#include "core/acmemory.h"
+
+/* PERF:
+ * Debug allocation tracker. Live blocks are kept in an open addressing hash
+ * table keyed by address (linear probing, backward shift on remove so there
+ * are no tombstones). The table memory comes straight from the platform layer
+ * so it never shows up in, or recurses into, the engine allocator.
+ * Every function here is a no-op when ACMEMORY_TRACKING is 0, the internal ones
+ * are inlined away so release frees pay nothing.
+ */
+
+typedef struct memory_snapshot
+{
+    u64 sequence; // allocations made after this point are newer than the snapshot.
+} memory_snapshot;
+
+#if ACMEMORY_TRACKING
+void alloc_tracker_initialize();
+
+// Reports blocks still alive grouped by call site, then releases the table.
+void alloc_tracker_shutdown();
+
+void alloc_tracker_add(void* block, u64 size, mem_tag tag, const char* file, u32 line);
+
+/* INFO:
+ * Returns: FALSE if the block is unknown (not from the engine allocator, or freed twice), the caller
+ *          must not free it. Once a block could not be added (table full) unknown blocks are
+ *          assumed to be that one and TRUE is returned with a warning.
+ */
+b8 alloc_tracker_remove(void* block, u64 size, mem_tag tag);
+#else
+static inline void alloc_tracker_initialize() {}
+static inline void alloc_tracker_shutdown() {}
+static inline void alloc_tracker_add(void* block, u64 size, mem_tag tag, const char* file, u32 line) {}
+static inline b8 alloc_tracker_remove(void* block, u64 size, mem_tag tag) { return TRUE; }
+#endif
+
+// Marks the current point in time.
+ACAPI void ac_memory_snapshot_t(memory_snapshot* out_snapshot);
+
+/* INFO:
+ * Logs every block allocated after snapshot that is still alive, grouped by call site.
+ * Returns: Number of such blocks.
+ */
+ACAPI u64 ac_memory_snapshot_diff_t(const memory_snapshot* snapshot);
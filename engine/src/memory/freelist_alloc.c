@@ -0,0 +1,205 @@
+#include "memory/freelist_alloc.h"
+
+#include "core/logger.h"
+
+// sits right before every user block.
+typedef struct freelist_header
+{
+    u64 size;   // bytes of the whole block, header and alignment padding included.
+    u64 offset; // user block - block start.
+} freelist_header;
+
+STATIC_ASSERT(sizeof(freelist_header) == FREELIST_ALLOC_ALIGNMENT, "freelist header must keep user blocks aligned");
+STATIC_ASSERT(sizeof(freelist_node) <= FREELIST_ALLOC_MIN_BLOCK, "a free node must fit in the smallest block");
+
+static inline u64 align_up(u64 value, u64 alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+b8 ac_freelist_alloc_create_t(const char* name, u64 total_size, void* memory, freelist_alloc* out_alloc)
+{
+    if (!out_alloc)
+        return FALSE;
+
+    if (!memory || total_size < FREELIST_ALLOC_MIN_BLOCK || ((u64)memory & (FREELIST_ALLOC_ALIGNMENT - 1)) != 0)
+    {
+        ACERROR("ac_freelist_alloc_create_t - '%s' needs an aligned block of at least %uB.", name, FREELIST_ALLOC_MIN_BLOCK);
+        return FALSE;
+    }
+
+    out_alloc->name = name;
+    out_alloc->total_size = total_size & ~((u64)FREELIST_ALLOC_ALIGNMENT - 1);
+    out_alloc->allocated = 0;
+    out_alloc->memory = memory;
+    out_alloc->head = memory;
+    out_alloc->head->size = out_alloc->total_size;
+    out_alloc->head->next = 0;
+    return TRUE;
+}
+
+void ac_freelist_alloc_destroy_t(freelist_alloc* alloc)
+{
+    if (!alloc)
+        return;
+
+    alloc->memory = 0;
+    alloc->head = 0;
+    alloc->total_size = 0;
+    alloc->allocated = 0;
+}
+
+void* ac_freelist_alloc_allocate_t(freelist_alloc* alloc, u64 size, u16 alignment)
+{
+    if (!alloc || !alloc->memory)
+        return 0;
+
+    if (alignment < FREELIST_ALLOC_ALIGNMENT)
+        alignment = FREELIST_ALLOC_ALIGNMENT;
+
+    // best fit: smallest node that can hold header, padding and size.
+    freelist_node* best = 0;
+    freelist_node* best_prev = 0;
+    u64 best_total = 0;
+    freelist_node* prev = 0;
+    for (freelist_node* node = alloc->head; node; prev = node, node = node->next)
+    {
+        u64 start = (u64)node;
+        u64 user = align_up(start + sizeof(freelist_header), alignment);
+        u64 total = align_up(user + size, FREELIST_ALLOC_ALIGNMENT) - start;
+        if (total > node->size)
+            continue;
+
+        if (!best || node->size < best->size)
+        {
+            best = node;
+            best_prev = prev;
+            best_total = total;
+            if (node->size == total)
+                break;
+        }
+    }
+
+    if (!best)
+        return 0;
+
+    freelist_node* next = best->next;
+    if (best->size - best_total >= FREELIST_ALLOC_MIN_BLOCK)
+    {
+        freelist_node* rest = (freelist_node*)((u8*)best + best_total);
+        rest->size = best->size - best_total;
+        rest->next = next;
+        next = rest;
+    }
+    else
+    {
+        // too small to track on its own, the block keeps it.
+        best_total = best->size;
+    }
+
+    if (best_prev)
+        best_prev->next = next;
+    else
+        alloc->head = next;
+
+    u64 user = align_up((u64)best + sizeof(freelist_header), alignment);
+    freelist_header* header = (freelist_header*)user - 1;
+    header->size = best_total;
+    header->offset = user - (u64)best;
+
+    alloc->allocated += best_total;
+    return (void*)user;
+}
+
+void ac_freelist_alloc_free_t(freelist_alloc* alloc, void* block)
+{
+    if (!alloc || !block)
+        return;
+
+    if (!ac_freelist_alloc_owns_t(alloc, block))
+    {
+        ACERROR("ac_freelist_alloc_free_t - '%s' does not own block %p.", alloc->name, block);
+        return;
+    }
+
+    // a freed block's header is overwritten by its free node, a bad offset means double free or corruption.
+    freelist_header* header = (freelist_header*)block - 1;
+    u64 size = header->size;
+    u64 offset = header->offset;
+    u8* start = (u8*)block - offset;
+    if (offset < sizeof(freelist_header) || offset > 65536 || (offset & (FREELIST_ALLOC_ALIGNMENT - 1)) != 0 ||
+        start < (u8*)alloc->memory || size < offset || start + size > (u8*)alloc->memory + alloc->total_size)
+    {
+        ACERROR("ac_freelist_alloc_free_t - '%s' block %p has a bad header, double free or heap corruption.", alloc->name, block);
+        return;
+    }
+
+    // find the free nodes around the block, the list is sorted by address.
+    freelist_node* prev = 0;
+    freelist_node* next = alloc->head;
+    while (next && (u8*)next < start)
+    {
+        prev = next;
+        next = next->next;
+    }
+
+    if ((prev && (u8*)prev + prev->size > start) || (u8*)next == start)
+    {
+        ACERROR("ac_freelist_alloc_free_t - '%s' block %p is already free.", alloc->name, block);
+        return;
+    }
+
+    alloc->allocated -= size;
+
+    freelist_node* node = (freelist_node*)start;
+    if (prev && (u8*)prev + prev->size == start)
+    {
+        prev->size += size;
+        node = prev;
+    }
+    else
+    {
+        node->size = size;
+        node->next = next;
+        if (prev)
+            prev->next = node;
+        else
+            alloc->head = node;
+    }
+
+    if (next && (u8*)node + node->size == (u8*)next)
+    {
+        node->size += next->size;
+        node->next = next->next;
+    }
+}
+
+b8 ac_freelist_alloc_owns_t(const freelist_alloc* alloc, const void* block)
+{
+    return alloc && alloc->memory && (const u8*)block >= (const u8*)alloc->memory &&
+           (const u8*)block < (const u8*)alloc->memory + alloc->total_size;
+}
+
+void ac_freelist_alloc_get_stats_t(const freelist_alloc* alloc, freelist_alloc_stats* out_stats)
+{
+    if (!out_stats)
+        return;
+
+    out_stats->free_size = 0;
+    out_stats->largest_free_block = 0;
+    out_stats->free_block_count = 0;
+    out_stats->fragmentation = 0.0f;
+    if (!alloc || !alloc->memory)
+        return;
+
+    for (freelist_node* node = alloc->head; node; node = node->next)
+    {
+        out_stats->free_size += node->size;
+        out_stats->free_block_count++;
+        if (node->size > out_stats->largest_free_block)
+            out_stats->largest_free_block = node->size;
+    }
+
+    if (out_stats->free_size)
+        out_stats->fragmentation = 1.0f - (f32)out_stats->largest_free_block / (f32)out_stats->free_size;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * General purpose allocator over one fixed block. Free space is kept as a list
+ * of nodes sorted by address; allocation picks the smallest node that fits
+ * (best-fit) and splits off the rest, free puts the block back and merges it
+ * with the neighbours it touches so the heap does not shatter over time.
+ * Both walk the free list, cost grows with the number of free blocks, not with
+ * the number of live allocations.
+ * +--------+---------------+------+------------+--------+-------------------+
+ * | header |   user block  | free | header ... |  free  |  header | block   |
+ * +--------+---------------+------+------------+--------+-------------------+
+ * ^ memory                 ^ free node -> next free node ^
+ */
+
+#define FREELIST_ALLOC_ALIGNMENT 16
+
+// smallest leftover worth splitting into its own free node.
+#define FREELIST_ALLOC_MIN_BLOCK 32
+
+typedef struct freelist_node
+{
+    u64 size; // bytes, node included.
+    struct freelist_node* next;
+} freelist_node;
+
+typedef struct freelist_alloc
+{
+    const char* name;
+    u64 total_size;
+    u64 allocated; // bytes taken by live blocks, headers and padding included.
+    void* memory;
+    freelist_node* head;
+} freelist_alloc;
+
+typedef struct freelist_alloc_stats
+{
+    u64 free_size;
+    u64 largest_free_block;
+    u64 free_block_count;
+    f32 fragmentation; // 0 = all free space in one block, close to 1 = free space scattered in small blocks.
+} freelist_alloc_stats;
+
+/* INFO:
+ * Creates a free list allocator over memory.
+ * name: Name used in error messages. Must outlive the allocator.
+ * total_size: Size in bytes of memory.
+ * memory: Backing block, must stay valid until destroy. Aligned to FREELIST_ALLOC_ALIGNMENT.
+ * Returns: FALSE if the block is too small or misaligned.
+ */
+ACAPI b8 ac_freelist_alloc_create_t(const char* name, u64 total_size, void* memory, freelist_alloc* out_alloc);
+ACAPI void ac_freelist_alloc_destroy_t(freelist_alloc* alloc);
+
+/* INFO:
+ * Returns size bytes aligned to alignment (power of two, at least FREELIST_ALLOC_ALIGNMENT is used),
+ * or 0 when no free block is big enough. Does not log, the caller decides how to handle it.
+ *
+ * WARN: The returned memory is NOT zeroed.
+ */
+ACAPI void* ac_freelist_alloc_allocate_t(freelist_alloc* alloc, u64 size, u16 alignment);
+ACAPI void ac_freelist_alloc_free_t(freelist_alloc* alloc, void* block);
+
+// TRUE if block points inside the allocator's memory.
+ACAPI b8 ac_freelist_alloc_owns_t(const freelist_alloc* alloc, const void* block);
+
+// Walks the free list, cost grows with the number of free blocks.
+ACAPI void ac_freelist_alloc_get_stats_t(const freelist_alloc* alloc, freelist_alloc_stats* out_stats);
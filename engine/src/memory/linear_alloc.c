@@ -0,0 +1,67 @@
+#include "memory/linear_alloc.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+
+void ac_linear_alloc_create_t(const char* name, u64 total_size, void* memory, linear_alloc* out_alloc)
+{
+    if (!out_alloc)
+        return;
+
+    out_alloc->name = name;
+    out_alloc->total_size = total_size;
+    out_alloc->allocated = 0;
+    out_alloc->high_water = 0;
+    out_alloc->own_memory = memory == 0;
+    if (memory)
+        out_alloc->memory = memory;
+    else
+        out_alloc->memory = ac_allocate_uninit_t(total_size, MEMTAG_LINEAR_ALLOC);
+
+    memory_register_linear_alloc(out_alloc);
+}
+
+void ac_linear_alloc_destroy_t(linear_alloc* alloc)
+{
+    if (!alloc)
+        return;
+
+    memory_unregister_linear_alloc(alloc);
+
+    if (alloc->own_memory && alloc->memory)
+        ac_free_t(alloc->memory, alloc->total_size, MEMTAG_LINEAR_ALLOC);
+
+    alloc->memory = 0;
+    alloc->total_size = 0;
+    alloc->allocated = 0;
+    alloc->own_memory = FALSE;
+}
+
+void* ac_linear_alloc_allocate_t(linear_alloc* alloc, u64 size)
+{
+    if (!alloc || !alloc->memory)
+    {
+        ACERROR("ac_linear_alloc_allocate_t - allocator not initialized.");
+        return 0;
+    }
+
+    u64 offset = (alloc->allocated + (LINEAR_ALLOC_ALIGNMENT - 1)) & ~((u64)LINEAR_ALLOC_ALIGNMENT - 1);
+    if (offset + size > alloc->total_size)
+    {
+        u64 remaining = alloc->total_size - alloc->allocated;
+        ACERROR("ac_linear_alloc_allocate_t - '%s' tried to allocate %lluB, only %lluB remaining.", alloc->name, size, remaining);
+        return 0;
+    }
+
+    alloc->allocated = offset + size;
+    if (alloc->allocated > alloc->high_water)
+        alloc->high_water = alloc->allocated;
+
+    return (u8*)alloc->memory + offset;
+}
+
+void ac_linear_alloc_reset_t(linear_alloc* alloc)
+{
+    if (alloc)
+        alloc->allocated = 0;
+}
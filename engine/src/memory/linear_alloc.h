@@ -0,0 +1,44 @@
+#pragma once
+
+#include "define.h"
+
+/* PERF:
+ * Linear (bump) allocator. Allocation only moves an offset forward, nothing
+ * is freed individually; the whole block is released at once with reset.
+ * +----------------------------------+-----------------------------+
+ * |    allocated (used so far)       |     free (total - used)     |
+ * +----------------------------------+-----------------------------+
+ * ^ memory                           ^ memory + allocated
+ */
+
+#define LINEAR_ALLOC_ALIGNMENT 16
+
+typedef struct linear_alloc
+{
+    const char* name;
+    u64 total_size;
+    u64 allocated;
+    u64 high_water; // biggest "allocated" value seen since create.
+    void* memory;
+    b8 own_memory;
+} linear_alloc;
+
+/* INFO:
+ * Creates a linear allocator.
+ * name: Name shown in the memory usage report. Must outlive the allocator.
+ * total_size: Size in bytes of the backing block.
+ * memory: Backing block to use. Pass 0 to let the allocator own one (MEMTAG_LINEAR_ALLOC).
+ * out_alloc: Allocator to initialize.
+ */
+ACAPI void ac_linear_alloc_create_t(const char* name, u64 total_size, void* memory, linear_alloc* out_alloc);
+ACAPI void ac_linear_alloc_destroy_t(linear_alloc* alloc);
+
+/* INFO:
+ * Returns a block of size bytes aligned to LINEAR_ALLOC_ALIGNMENT, or 0 when the allocator is full.
+ *
+ * WARN: The returned memory is NOT zeroed.
+ */
+ACAPI void* ac_linear_alloc_allocate_t(linear_alloc* alloc, u64 size);
+
+// Releases every allocation at once. Does not touch the backing memory.
+ACAPI void ac_linear_alloc_reset_t(linear_alloc* alloc);
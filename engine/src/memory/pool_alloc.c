@@ -0,0 +1,190 @@
+#include "memory/pool_alloc.h"
+
+#include "core/logger.h"
+
+static u64 pool_chunk_size(pool_alloc* pool)
+{
+    u64 size = POOL_ALLOC_CHUNK_HEADER + pool->block_size * pool->blocks_per_chunk;
+#if POOL_ALLOC_POISON
+    // free bits, one per block.
+    size += (pool->blocks_per_chunk + 63) / 64 * sizeof(u64);
+#endif
+    return size;
+}
+
+#if POOL_ALLOC_POISON
+// the free bits sit after the blocks, block_size is a multiple of 8 so they stay aligned.
+static u64* pool_free_bits(pool_alloc* pool, u8* chunk)
+{
+    return (u64*)(chunk + POOL_ALLOC_CHUNK_HEADER + pool->block_size * pool->blocks_per_chunk);
+}
+
+// finds the chunk holding block. FALSE if block is not the start of one of the pool's blocks.
+static b8 pool_find(pool_alloc* pool, u8* block, u64** out_bits, u64* out_index)
+{
+    u64 blocks_size = pool->block_size * pool->blocks_per_chunk;
+    for (u8* chunk = pool->chunks; chunk; chunk = *(void**)chunk)
+    {
+        u8* first = chunk + POOL_ALLOC_CHUNK_HEADER;
+        if (block >= first && block < first + blocks_size)
+        {
+            if ((u64)(block - first) % pool->block_size != 0)
+                return FALSE;
+            *out_bits = pool_free_bits(pool, chunk);
+            *out_index = (u64)(block - first) / pool->block_size;
+            return TRUE;
+        }
+    }
+    return FALSE;
+}
+
+static b8 pool_block_is_poisoned(pool_alloc* pool, u8* block)
+{
+    for (u64 i = sizeof(void*); i < pool->block_size; ++i)
+    {
+        if (block[i] != POOL_ALLOC_POISON_FREE)
+            return FALSE;
+    }
+    return TRUE;
+}
+#endif
+
+static b8 pool_grow(pool_alloc* pool)
+{
+    u8* chunk = ac_allocate_uninit_t(pool_chunk_size(pool), pool->tag);
+    if (!chunk)
+        return FALSE;
+
+    *(void**)chunk = pool->chunks;
+    pool->chunks = chunk;
+
+#if POOL_ALLOC_POISON
+    // every block starts free.
+    ac_set_memory_t(pool_free_bits(pool, chunk), 0xFF, (pool->blocks_per_chunk + 63) / 64 * sizeof(u64));
+#endif
+
+    // thread the new blocks into the free list, keeping the first block at the head.
+    u8* blocks = chunk + POOL_ALLOC_CHUNK_HEADER;
+    for (u64 i = pool->blocks_per_chunk; i > 0; --i)
+    {
+        u8* block = blocks + (i - 1) * pool->block_size;
+#if POOL_ALLOC_POISON
+        ac_set_memory_t(block, POOL_ALLOC_POISON_FREE, pool->block_size);
+#endif
+        *(void**)block = pool->free_list;
+        pool->free_list = block;
+    }
+
+    pool->chunk_count++;
+    pool->capacity += pool->blocks_per_chunk;
+    return TRUE;
+}
+
+void ac_pool_alloc_create_t(const char* name, u64 block_size, u64 blocks_per_chunk, mem_tag tag, pool_alloc* out_pool)
+{
+    if (!out_pool)
+        return;
+
+    // blocks must be able to hold the free list pointer and keep the next block aligned.
+    u64 alignment = block_size > sizeof(void*) ? 16 : sizeof(void*);
+    block_size = block_size < sizeof(void*) ? sizeof(void*) : block_size;
+
+    ac_zero_memory_t(out_pool, sizeof(pool_alloc));
+    out_pool->name = name;
+    out_pool->tag = tag;
+    out_pool->block_size = (block_size + alignment - 1) & ~(alignment - 1);
+    out_pool->blocks_per_chunk = blocks_per_chunk ? blocks_per_chunk : 1;
+}
+
+void ac_pool_alloc_destroy_t(pool_alloc* pool)
+{
+    if (!pool)
+        return;
+
+    if (pool->in_use != 0)
+        ACWARN("Pool '%s' destroyed with %llu blocks still in use.", pool->name, pool->in_use);
+
+    u64 chunk_size = pool_chunk_size(pool);
+    u8* chunk = pool->chunks;
+    while (chunk)
+    {
+        u8* next = *(void**)chunk;
+        ac_free_t(chunk, chunk_size, pool->tag);
+        chunk = next;
+    }
+
+    pool->chunks = 0;
+    pool->free_list = 0;
+    pool->chunk_count = 0;
+    pool->capacity = 0;
+    pool->in_use = 0;
+}
+
+void* ac_pool_alloc_allocate_t(pool_alloc* pool)
+{
+    if (!pool->free_list && !pool_grow(pool))
+    {
+        ACERROR("ac_pool_alloc_allocate_t - pool '%s' failed to grow.", pool->name);
+        return 0;
+    }
+
+    u8* block = pool->free_list;
+    pool->free_list = *(void**)block;
+
+#if POOL_ALLOC_POISON
+    u64* free_bits;
+    u64 index;
+    if (pool_find(pool, block, &free_bits, &index))
+        free_bits[index / 64] &= ~(1ull << (index % 64));
+    // the contents only tell about writes after free, the free bits decide what is free.
+    if (!pool_block_is_poisoned(pool, block))
+        ACWARN("Pool '%s' block %p was written after being freed.", pool->name, block);
+#endif
+
+    ac_zero_memory_t(block, pool->block_size);
+
+    pool->in_use++;
+    if (pool->in_use > pool->peak_in_use)
+        pool->peak_in_use = pool->in_use;
+
+    return block;
+}
+
+void ac_pool_alloc_free_t(pool_alloc* pool, void* block)
+{
+    if (!block)
+        return;
+
+#if POOL_ALLOC_POISON
+    u64* free_bits;
+    u64 index;
+    if (!pool_find(pool, block, &free_bits, &index))
+    {
+        ACERROR("ac_pool_alloc_free_t - block %p does not belong to pool '%s'.", block, pool->name);
+        return;
+    }
+    u64 bit = 1ull << (index % 64);
+    if (free_bits[index / 64] & bit)
+    {
+        ACERROR("ac_pool_alloc_free_t - block %p of pool '%s' is already free (double free?).", block, pool->name);
+        return;
+    }
+
+    free_bits[index / 64] |= bit;
+    ac_set_memory_t(block, POOL_ALLOC_POISON_FREE, pool->block_size);
+#endif
+
+    *(void**)block = pool->free_list;
+    pool->free_list = block;
+    pool->in_use--;
+}
+
+b8 ac_pool_alloc_reserve_t(pool_alloc* pool, u64 count)
+{
+    while (pool->capacity - pool->in_use < count)
+    {
+        if (!pool_grow(pool))
+            return FALSE;
+    }
+    return TRUE;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "define.h"
+#include "core/acmemory.h"
+
+/* PERF:
+ * Fixed-size block pool. Memory is grabbed in chunks of blocks_per_chunk blocks
+ * and every free block stores the pointer to the next free block in its first
+ * bytes (intrusive free list), so allocate/free are a single pointer swap.
+ * +-------------+---------+---------+---------+-----+
+ * | next chunk  | block 0 | block 1 | block 2 | ... |
+ * +-------------+---------+---------+---------+-----+
+ * |  16 bytes   |      block_size each              |
+ * +-------------+-----------------------------------+
+ */
+
+#define POOL_ALLOC_CHUNK_HEADER 16
+
+#if defined(_DEBUG)
+// fill freed blocks and check them on reuse, track free blocks in a bit per block after each chunk.
+#define POOL_ALLOC_POISON 1
+#else
+#define POOL_ALLOC_POISON 0
+#endif
+
+#define POOL_ALLOC_POISON_FREE 0xDD
+
+typedef struct pool_alloc
+{
+    const char* name;
+    mem_tag tag;
+    u64 block_size;
+    u64 blocks_per_chunk;
+
+    void* free_list;
+    void* chunks;
+
+    // occupancy
+    u64 chunk_count;
+    u64 capacity; // blocks across all chunks
+    u64 in_use;
+    u64 peak_in_use;
+} pool_alloc;
+
+/* INFO:
+ * Creates a pool of same sized blocks. No memory is taken until the first allocation.
+ * name: Name used in warnings. Must outlive the pool.
+ * block_size: Size in bytes of every block. Rounded up to keep blocks aligned.
+ * blocks_per_chunk: How many blocks are added every time the pool runs out.
+ * tag: Memory tag the chunks are accounted under.
+ * out_pool: Pool to initialize.
+ */
+ACAPI void ac_pool_alloc_create_t(const char* name, u64 block_size, u64 blocks_per_chunk, mem_tag tag, pool_alloc* out_pool);
+
+// Releases every chunk. Blocks still in use become invalid.
+ACAPI void ac_pool_alloc_destroy_t(pool_alloc* pool);
+
+// Returns a zeroed block, growing the pool by one chunk if needed.
+ACAPI void* ac_pool_alloc_allocate_t(pool_alloc* pool);
+ACAPI void ac_pool_alloc_free_t(pool_alloc* pool, void* block);
+
+// Grows the pool until at least count blocks are free. Returns FALSE if a chunk can't be allocated.
+ACAPI b8 ac_pool_alloc_reserve_t(pool_alloc* pool, u64 count);
+
+#define ac_pool_alloc_create_type_t(name, type, blocks_per_chunk, tag, out_pool)                                                           \
+    ac_pool_alloc_create_t(name, sizeof(type), blocks_per_chunk, tag, out_pool)
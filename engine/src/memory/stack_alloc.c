@@ -0,0 +1,76 @@
+#include "memory/stack_alloc.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+
+static ACTHREAD_LOCAL stack_alloc thread_stack;
+
+void ac_stack_alloc_create_t(const char* name, u64 total_size, void* memory, stack_alloc* out_alloc)
+{
+    if (!out_alloc)
+        return;
+
+    ac_linear_alloc_create_t(name, total_size, memory, &out_alloc->arena);
+}
+
+void ac_stack_alloc_destroy_t(stack_alloc* alloc)
+{
+    if (!alloc)
+        return;
+
+    if (alloc->arena.memory && alloc->arena.allocated != 0)
+        ACWARN("Stack allocator '%s' destroyed with %lluB still pushed.", alloc->arena.name, alloc->arena.allocated);
+
+    ac_linear_alloc_destroy_t(&alloc->arena);
+}
+
+void* ac_stack_alloc_push_t(stack_alloc* alloc, u64 size)
+{
+    if (!alloc || !alloc->arena.memory)
+    {
+        ACERROR("ac_stack_alloc_push_t - allocator not initialized.");
+        return 0;
+    }
+
+    // linear alloc reports the overflow.
+    return ac_linear_alloc_allocate_t(&alloc->arena, size);
+}
+
+stack_alloc_marker ac_stack_alloc_get_marker_t(stack_alloc* alloc)
+{
+    return alloc ? alloc->arena.allocated : 0;
+}
+
+void ac_stack_alloc_pop_to_marker_t(stack_alloc* alloc, stack_alloc_marker marker)
+{
+    if (!alloc)
+        return;
+
+    if (marker > alloc->arena.allocated)
+    {
+        ACERROR("ac_stack_alloc_pop_to_marker_t - '%s' marker %llu is above the top (%llu), markers popped out of order?",
+                alloc->arena.name,
+                marker,
+                alloc->arena.allocated);
+        return;
+    }
+
+#if STACK_ALLOC_POISON
+    ac_set_memory_t((u8*)alloc->arena.memory + marker, STACK_ALLOC_POISON_POPPED, alloc->arena.allocated - marker);
+#endif
+    alloc->arena.allocated = marker;
+}
+
+stack_alloc* ac_stack_alloc_thread_t()
+{
+    if (!thread_stack.arena.memory)
+        ac_stack_alloc_create_t("thread_stack", STACK_ALLOC_THREAD_SIZE, 0, &thread_stack);
+
+    return &thread_stack;
+}
+
+void ac_stack_alloc_thread_release_t()
+{
+    if (thread_stack.arena.memory)
+        ac_stack_alloc_destroy_t(&thread_stack);
+}
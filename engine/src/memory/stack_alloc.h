@@ -0,0 +1,73 @@
+#pragma once
+
+#include "define.h"
+#include "memory/linear_alloc.h"
+
+/* PERF:
+ * Stack allocator. Same bump pointer as the linear allocator, but the top can be
+ * saved as a marker and rolled back to it later, so nested scopes free their
+ * temporaries in LIFO order without touching malloc.
+ * +-------------+---------------+----------------+---------------------------+
+ * |  scope A    |   scope B     |    scope C     |           free            |
+ * +-------------+---------------+----------------+---------------------------+
+ *               ^ marker B      ^ marker C       ^ top
+ * pop_to_marker(C) drops scope C only, pop_to_marker(B) drops B and C.
+ */
+
+#define STACK_ALLOC_ALIGNMENT LINEAR_ALLOC_ALIGNMENT
+
+// size of the stack every thread gets from ac_stack_alloc_thread_t.
+#define STACK_ALLOC_THREAD_SIZE (512 * 1024)
+
+#if defined(_DEBUG)
+#define STACK_ALLOC_POISON 1 // fill popped memory so reads of dead temporaries stand out.
+#else
+#define STACK_ALLOC_POISON 0
+#endif
+
+#define STACK_ALLOC_POISON_POPPED 0xCD
+
+typedef u64 stack_alloc_marker;
+
+typedef struct stack_alloc
+{
+    linear_alloc arena; // arena.allocated is the top of the stack.
+} stack_alloc;
+
+/* INFO:
+ * Creates a stack allocator.
+ * name: Name shown in the memory usage report. Must outlive the allocator.
+ * total_size: Size in bytes of the backing block.
+ * memory: Backing block to use. Pass 0 to let the allocator own one (MEMTAG_LINEAR_ALLOC).
+ * out_alloc: Allocator to initialize.
+ */
+ACAPI void ac_stack_alloc_create_t(const char* name, u64 total_size, void* memory, stack_alloc* out_alloc);
+ACAPI void ac_stack_alloc_destroy_t(stack_alloc* alloc);
+
+/* INFO:
+ * Returns a block of size bytes aligned to STACK_ALLOC_ALIGNMENT, or 0 (and logs an error)
+ * when the stack would overflow.
+ *
+ * WARN: The returned memory is NOT zeroed.
+ */
+ACAPI void* ac_stack_alloc_push_t(stack_alloc* alloc, u64 size);
+
+// Saves the current top. Everything pushed after this is released by ac_stack_alloc_pop_to_marker_t.
+ACAPI stack_alloc_marker ac_stack_alloc_get_marker_t(stack_alloc* alloc);
+
+/* INFO:
+ * Releases everything pushed since marker was taken.
+ *
+ * WARN: Markers must be popped in the reverse order they were taken. Popping to a marker
+ * that is above the current top (already popped by an outer scope) is an error and is ignored.
+ */
+ACAPI void ac_stack_alloc_pop_to_marker_t(stack_alloc* alloc, stack_alloc_marker marker);
+
+/* INFO:
+ * Returns the calling thread's stack, created on first use with STACK_ALLOC_THREAD_SIZE bytes.
+ * Meant for scoped temporaries: take a marker, push, pop to the marker before returning.
+ *
+ * WARN: Each thread that used it must call ac_stack_alloc_thread_release_t before it exits.
+ */
+ACAPI stack_alloc* ac_stack_alloc_thread_t();
+ACAPI void ac_stack_alloc_thread_release_t();
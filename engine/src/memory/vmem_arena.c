@@ -0,0 +1,101 @@
+#include "memory/vmem_arena.h"
+
+#include "core/logger.h"
+#include "platform/platform.h"
+
+static u64 round_up(u64 value, u64 granularity)
+{
+    return ((value + granularity - 1) / granularity) * granularity;
+}
+
+b8 ac_vmem_arena_create_t(const char* name, u64 reserve_size, mem_tag tag, b8 huge_pages, vmem_arena* out_arena)
+{
+    if (!out_arena)
+        return FALSE;
+
+    ac_zero_memory_t(out_arena, sizeof(vmem_arena));
+
+    u64 page_size = platform_page_size();
+    out_arena->commit_size = round_up(huge_pages ? VMEM_ARENA_HUGE_COMMIT_SIZE : VMEM_ARENA_COMMIT_SIZE, page_size);
+    out_arena->reserved = round_up(reserve_size, out_arena->commit_size);
+
+    out_arena->base = platform_reserve_memory(out_arena->reserved);
+    if (!out_arena->base)
+    {
+        ACERROR("ac_vmem_arena_create_t - '%s' failed to reserve %lluB of address space.", name, out_arena->reserved);
+        out_arena->reserved = 0;
+        return FALSE;
+    }
+
+    out_arena->name = name;
+    out_arena->tag = tag;
+    out_arena->huge_pages = huge_pages;
+    return TRUE;
+}
+
+void ac_vmem_arena_destroy_t(vmem_arena* arena)
+{
+    if (!arena || !arena->base)
+        return;
+
+    memory_record_external_free(arena->committed, arena->tag);
+    platform_release_memory(arena->base, arena->reserved);
+    ac_zero_memory_t(arena, sizeof(vmem_arena));
+}
+
+void* ac_vmem_arena_allocate_t(vmem_arena* arena, u64 size)
+{
+    if (!arena || !arena->base)
+    {
+        ACERROR("ac_vmem_arena_allocate_t - arena not initialized.");
+        return 0;
+    }
+
+    u64 offset = round_up(arena->allocated, VMEM_ARENA_ALIGNMENT);
+    u64 end = offset + size;
+    if (end > arena->reserved)
+    {
+        ACERROR("ac_vmem_arena_allocate_t - '%s' out of reserved space (%lluB reserved, %lluB requested).",
+                arena->name,
+                arena->reserved,
+                end);
+        return 0;
+    }
+
+    if (end > arena->committed)
+    {
+        u64 new_committed = round_up(end, arena->commit_size);
+        if (new_committed > arena->reserved)
+            new_committed = arena->reserved;
+
+        u64 commit_bytes = new_committed - arena->committed;
+        if (!platform_commit_memory(arena->base + arena->committed, commit_bytes, arena->huge_pages))
+        {
+            ACERROR("ac_vmem_arena_allocate_t - '%s' failed to commit %lluB.", arena->name, commit_bytes);
+            return 0;
+        }
+
+        memory_record_external_allocate(commit_bytes, arena->tag);
+        arena->committed = new_committed;
+    }
+
+    arena->allocated = end;
+    if (arena->allocated > arena->high_water)
+        arena->high_water = arena->allocated;
+
+    return arena->base + offset;
+}
+
+void ac_vmem_arena_reset_t(vmem_arena* arena, b8 decommit)
+{
+    if (!arena || !arena->base)
+        return;
+
+    arena->allocated = 0;
+    if (decommit && arena->committed)
+    {
+        platform_decommit_memory(arena->base, arena->committed);
+        memory_record_external_free(arena->committed, arena->tag);
+        arena->committed = 0;
+    }
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "define.h"
+#include "core/acmemory.h"
+
+/* PERF:
+ * Virtual memory arena. The whole address range is reserved up front (no
+ * physical memory behind it) and pages are committed only as the arena grows,
+ * so growing never moves or copies what was already allocated and pointers
+ * into the arena stay valid until reset/destroy.
+ * +---------------------+---------------------+--------------------------+
+ * |      allocated      | committed, unused   | reserved, not committed  |
+ * +---------------------+---------------------+--------------------------+
+ * ^ base                ^ base + allocated    ^ base + committed         ^ base + reserved
+ */
+
+#define VMEM_ARENA_ALIGNMENT 16
+#define VMEM_ARENA_COMMIT_SIZE (64 * 1024)
+#define VMEM_ARENA_HUGE_COMMIT_SIZE (2 * 1024 * 1024)
+
+typedef struct vmem_arena
+{
+    const char* name;
+    u8* base;
+    u64 reserved;
+    u64 committed;
+    u64 allocated;
+    u64 high_water;
+    u64 commit_size; // granularity pages are committed in.
+    mem_tag tag;     // committed bytes are accounted under this tag.
+    b8 huge_pages;
+} vmem_arena;
+
+/* INFO:
+ * Reserves reserve_size bytes of address space. Nothing is committed yet.
+ * name: Name used in warnings. Must outlive the arena.
+ * reserve_size: Upper bound the arena can grow to. Can be far larger than physical memory.
+ * tag: Tag the committed memory is accounted under.
+ * huge_pages: Hint to back the arena with transparent huge pages (Linux only).
+ * Returns: FALSE if the address space could not be reserved.
+ */
+ACAPI b8 ac_vmem_arena_create_t(const char* name, u64 reserve_size, mem_tag tag, b8 huge_pages, vmem_arena* out_arena);
+ACAPI void ac_vmem_arena_destroy_t(vmem_arena* arena);
+
+/* INFO:
+ * Returns size bytes aligned to VMEM_ARENA_ALIGNMENT, committing more pages if needed.
+ * Returns 0 when the reserved range is exhausted.
+ *
+ * NOTE: Freshly committed pages are zero, pages reused after a reset without decommit are not.
+ */
+ACAPI void* ac_vmem_arena_allocate_t(vmem_arena* arena, u64 size);
+
+// Releases every allocation. With decommit the physical pages are given back to the OS as well.
+ACAPI void ac_vmem_arena_reset_t(vmem_arena* arena, b8 decommit);
@@ -11,15 +11,75 @@ b8 platform_startup(platform_state* plat_state, const char* app_name, i32 x, i32
 void platform_shutdown(platform_state* plat_state);
 b8 platform_push_msg(platform_state* plat_state);
 
+// alignment used by platform_allocated when aligned is TRUE (one cache line).
+#define PLATFORM_DEFAULT_ALIGNMENT 64
+// alignment malloc already gives on 64-bit targets.
+#define PLATFORM_MALLOC_ALIGNMENT 16
+
 // function for memory allocation
 void* platform_allocated(u64 size, b8 aligned);
 void platform_free(void* block, b8 aligned);
+// alignment must be a power of two. Free with platform_free_aligned.
+void* platform_allocated_aligned(u64 size, u64 alignment);
+void platform_free_aligned(void* block);
+
+// virtual memory: reserve address space up front, commit pages on demand.
+// address and size for commit/decommit must be page aligned.
+u64 platform_page_size();
+void* platform_reserve_memory(u64 size);
+// huge_page_hint asks the OS to back the range with transparent huge pages when it can.
+b8 platform_commit_memory(void* address, u64 size, b8 huge_page_hint);
+void platform_decommit_memory(void* address, u64 size);
+void platform_release_memory(void* address, u64 size);
+
+// large pages: fewer TLB misses for big, long lived blocks.
+#define PLATFORM_LARGE_PAGE_SIZE (2 * 1024 * 1024)
+
+typedef enum platform_page_kind
+{
+    PLATFORM_PAGE_NORMAL = 0,
+    PLATFORM_PAGE_TRANSPARENT_HUGE, // normal pages the OS was asked to promote (THP), not guaranteed.
+    PLATFORM_PAGE_HUGE,             // explicit huge/large pages, guaranteed.
+    PLATFORM_PAGE_KIND_MAX,
+} platform_page_kind;
+
+// size is rounded up to PLATFORM_LARGE_PAGE_SIZE, the block is aligned to it and zeroed.
+// tries explicit huge pages first, then falls back. out_kind tells what the block got.
+void* platform_allocate_large(u64 size, platform_page_kind* out_kind);
+// size must be the one given to platform_allocate_large.
+void platform_free_large(void* block, u64 size);
+
 void* platform_zero_mem(void* block, u64 size);
 void* platform_copy_mem(void* dest, const void* source, u64 size);
+// like platform_copy_mem but source and dest may overlap.
+void* platform_move_mem(void* dest, const void* source, u64 size);
 void* platform_set_mem(void* dest, i32 value, u64 size);
 
+// bulk variants with non-temporal stores (SSE2/AVX2 picked at runtime), the written data skips the cache.
+// below PLATFORM_STREAM_THRESHOLD they behave like the plain versions.
+#define PLATFORM_STREAM_THRESHOLD (256 * 1024)
+void* platform_stream_copy_mem(void* dest, const void* source, u64 size);
+void* platform_stream_set_mem(void* dest, i32 value, u64 size);
+void* platform_stream_zero_mem(void* block, u64 size);
+// instruction set the stream functions use: "AVX2", "SSE2" or "none".
+const char* platform_stream_isa();
+
 void platform_console_write(const char* msg, u8 color);
 void platform_console_write_error(const char* msg, u8 color);
 
 f64 platform_get_absolute_time();
 void platform_sleep(u64 ms);
+
+// threads: start runs on a new OS thread, join waits for it and releases the handle.
+typedef void (*pfn_thread_start)(void* param);
+typedef struct platform_thread
+{
+    u64 handle;
+} platform_thread;
+
+b8 platform_thread_create(pfn_thread_start start, void* param, platform_thread* out_thread);
+void platform_thread_join(platform_thread* thread);
+// gives the rest of the time slice to another ready thread.
+void platform_thread_yield();
+// logical processors the OS reports, at least 1.
+u32 platform_processor_count();
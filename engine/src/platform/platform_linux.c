@@ -2,7 +2,6 @@
 
 #if ACPLATFORM_LINUX
 
-#include "container/dyn_array.h"
 #include "core/event.h"
 #include "core/input.h"
 #include "core/logger.h"
@@ -11,6 +10,9 @@
 #include <X11/Xlib-xcb.h>
 #include <X11/Xlib.h>
 #include <X11/keysym.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
 #include <sys/time.h>
 #include <xcb/xcb.h>
 
@@ -23,8 +25,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #define VK_USE_PLATFORM_XCB_KHR
+#include "renderer/vulkan/vulkan_platform.h"
 #include "renderer/vulkan/vulkan_type.inl"
 #include <vulkan/vulkan.h>
 
@@ -216,14 +220,113 @@ b8 platform_push_msg(platform_state* plat_state)
 
 void* platform_allocated(u64 size, b8 aligned)
 {
+    if (aligned)
+        return platform_allocated_aligned(size, PLATFORM_DEFAULT_ALIGNMENT);
+
     return malloc(size);
 }
 
 void platform_free(void* block, b8 aligned)
+{
+    // posix_memalign blocks are released with free as well.
+    free(block);
+}
+
+void* platform_allocated_aligned(u64 size, u64 alignment)
+{
+    if (alignment < sizeof(void*))
+        alignment = sizeof(void*);
+
+    void* block = 0;
+    if (posix_memalign(&block, alignment, size) != 0)
+        return 0;
+
+    return block;
+}
+
+void platform_free_aligned(void* block)
 {
     free(block);
 }
 
+u64 platform_page_size()
+{
+    return (u64)sysconf(_SC_PAGESIZE);
+}
+
+void* platform_reserve_memory(u64 size)
+{
+    void* address = mmap(0, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return address == MAP_FAILED ? 0 : address;
+}
+
+b8 platform_commit_memory(void* address, u64 size, b8 huge_page_hint)
+{
+    if (mprotect(address, size, PROT_READ | PROT_WRITE) != 0)
+        return FALSE;
+
+#if defined(MADV_HUGEPAGE)
+    // only a hint, THP may be disabled system wide.
+    if (huge_page_hint)
+        madvise(address, size, MADV_HUGEPAGE);
+#endif
+    return TRUE;
+}
+
+void platform_decommit_memory(void* address, u64 size)
+{
+    // give the pages back to the OS but keep the address range reserved.
+    madvise(address, size, MADV_DONTNEED);
+    mprotect(address, size, PROT_NONE);
+}
+
+void platform_release_memory(void* address, u64 size)
+{
+    munmap(address, size);
+}
+
+void* platform_allocate_large(u64 size, platform_page_kind* out_kind)
+{
+    size = (size + PLATFORM_LARGE_PAGE_SIZE - 1) & ~((u64)PLATFORM_LARGE_PAGE_SIZE - 1);
+
+#if defined(MAP_HUGETLB)
+    // needs pages set aside in /proc/sys/vm/nr_hugepages, fails otherwise.
+    void* block = mmap(0, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (block != MAP_FAILED)
+    {
+        *out_kind = PLATFORM_PAGE_HUGE;
+        return block;
+    }
+#endif
+
+    // over-map so the block can start on a 2MiB boundary, THP only promotes aligned ranges.
+    u64 mapped_size = size + PLATFORM_LARGE_PAGE_SIZE;
+    u8* mapped = mmap(0, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED)
+        return 0;
+
+    u8* aligned = (u8*)(((u64)mapped + PLATFORM_LARGE_PAGE_SIZE - 1) & ~((u64)PLATFORM_LARGE_PAGE_SIZE - 1));
+    u64 head = aligned - mapped;
+    u64 tail = mapped_size - head - size;
+    if (head)
+        munmap(mapped, head);
+    if (tail)
+        munmap(aligned + size, tail);
+
+    *out_kind = PLATFORM_PAGE_NORMAL;
+#if defined(MADV_HUGEPAGE)
+    if (madvise(aligned, size, MADV_HUGEPAGE) == 0)
+        *out_kind = PLATFORM_PAGE_TRANSPARENT_HUGE;
+#endif
+    return aligned;
+}
+
+void platform_free_large(void* block, u64 size)
+{
+    size = (size + PLATFORM_LARGE_PAGE_SIZE - 1) & ~((u64)PLATFORM_LARGE_PAGE_SIZE - 1);
+    munmap(block, size);
+}
+
 void* platform_zero_mem(void* block, u64 size)
 {
     return memset(block, 0, size);
@@ -234,6 +337,11 @@ void* platform_copy_mem(void* dest, const void* source, u64 size)
     return memcpy(dest, source, size);
 }
 
+void* platform_move_mem(void* dest, const void* source, u64 size)
+{
+    return memmove(dest, source, size);
+}
+
 void* platform_set_mem(void* dest, i32 value, u64 size)
 {
     return memset(dest, value, size);
@@ -275,9 +383,57 @@ void platform_sleep(u64 ms)
 #endif
 }
 
-void platform_get_required_extension_name(const char*** names_dyn_array)
+typedef struct thread_start_info
+{
+    pfn_thread_start start;
+    void* param;
+} thread_start_info;
+
+// pthread wants void* (*)(void*), run the engine signature from here.
+static void* thread_trampoline(void* arg)
+{
+    thread_start_info info = *(thread_start_info*)arg;
+    free(arg);
+    info.start(info.param);
+    return 0;
+}
+
+b8 platform_thread_create(pfn_thread_start start, void* param, platform_thread* out_thread)
+{
+    thread_start_info* info = malloc(sizeof(thread_start_info));
+    if (!info)
+        return FALSE;
+    info->start = start;
+    info->param = param;
+
+    pthread_t thread;
+    if (pthread_create(&thread, 0, thread_trampoline, info) != 0)
+    {
+        ACERROR("platform_thread_create - pthread_create failed.");
+        free(info);
+        return FALSE;
+    }
+    out_thread->handle = (u64)thread;
+    return TRUE;
+}
+
+void platform_thread_join(platform_thread* thread)
+{
+    pthread_join((pthread_t)thread->handle, 0);
+    thread->handle = 0;
+}
+
+void platform_thread_yield() { sched_yield(); }
+
+u32 platform_processor_count()
+{
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (u32)count : 1;
+}
+
+void platform_get_required_extension_name(vulkan_name_list* names)
 {
-    ac_dyn_array_push_t(*names_dyn_array, &"VK_KHR_xcb_surface");
+    ac_small_array_push_t(names, "VK_KHR_xcb_surface");
 }
 
 b8 platform_create_vulkan_surface(struct platform_state* plat_state, struct vulkan_context* context)
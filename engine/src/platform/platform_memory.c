@@ -0,0 +1,215 @@
+#include "platform/platform.h"
+
+#include <string.h>
+
+/* PERF:
+ * Streaming (non-temporal) stores write whole cache lines straight to memory
+ * without reading them into the cache first, so a multi-megabyte copy does not
+ * evict the working set of everything else. Only worth it for big buffers that
+ * are not read again soon, below PLATFORM_STREAM_THRESHOLD plain memcpy/memset
+ * is used. The SSE2/AVX2 path is picked once at runtime from cpuid.
+ */
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define PLATFORM_MEMORY_X64 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define PLATFORM_MEMORY_X64 0
+#endif
+
+typedef void (*pfn_stream_copy)(u8* dest, const u8* source, u64 size);
+typedef void (*pfn_stream_set)(u8* dest, u8 value, u64 size);
+
+static void stream_copy_resolve(u8* dest, const u8* source, u64 size);
+static void stream_set_resolve(u8* dest, u8 value, u64 size);
+
+static pfn_stream_copy stream_copy = stream_copy_resolve;
+static pfn_stream_set stream_set = stream_set_resolve;
+static const char* stream_isa = 0;
+
+#if PLATFORM_MEMORY_X64
+__attribute__((target("sse2"))) static void stream_copy_sse2(u8* dest, const u8* source, u64 size)
+{
+    // stores need 16 byte alignment, copy the head normally.
+    u64 head = (16 - ((u64)dest & 15)) & 15;
+    memcpy(dest, source, head);
+    dest += head;
+    source += head;
+    size -= head;
+
+    for (; size >= 64; size -= 64, dest += 64, source += 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)source);
+        __m128i b = _mm_loadu_si128((const __m128i*)(source + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(source + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(source + 48));
+        _mm_stream_si128((__m128i*)dest, a);
+        _mm_stream_si128((__m128i*)(dest + 16), b);
+        _mm_stream_si128((__m128i*)(dest + 32), c);
+        _mm_stream_si128((__m128i*)(dest + 48), d);
+    }
+    _mm_sfence();
+    memcpy(dest, source, size);
+}
+
+__attribute__((target("sse2"))) static void stream_set_sse2(u8* dest, u8 value, u64 size)
+{
+    u64 head = (16 - ((u64)dest & 15)) & 15;
+    memset(dest, value, head);
+    dest += head;
+    size -= head;
+
+    __m128i v = _mm_set1_epi8((char)value);
+    for (; size >= 64; size -= 64, dest += 64)
+    {
+        _mm_stream_si128((__m128i*)dest, v);
+        _mm_stream_si128((__m128i*)(dest + 16), v);
+        _mm_stream_si128((__m128i*)(dest + 32), v);
+        _mm_stream_si128((__m128i*)(dest + 48), v);
+    }
+    _mm_sfence();
+    memset(dest, value, size);
+}
+
+__attribute__((target("avx2"))) static void stream_copy_avx2(u8* dest, const u8* source, u64 size)
+{
+    u64 head = (32 - ((u64)dest & 31)) & 31;
+    memcpy(dest, source, head);
+    dest += head;
+    source += head;
+    size -= head;
+
+    for (; size >= 128; size -= 128, dest += 128, source += 128)
+    {
+        __m256i a = _mm256_loadu_si256((const __m256i*)source);
+        __m256i b = _mm256_loadu_si256((const __m256i*)(source + 32));
+        __m256i c = _mm256_loadu_si256((const __m256i*)(source + 64));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(source + 96));
+        _mm256_stream_si256((__m256i*)dest, a);
+        _mm256_stream_si256((__m256i*)(dest + 32), b);
+        _mm256_stream_si256((__m256i*)(dest + 64), c);
+        _mm256_stream_si256((__m256i*)(dest + 96), d);
+    }
+    _mm_sfence();
+    memcpy(dest, source, size);
+}
+
+__attribute__((target("avx2"))) static void stream_set_avx2(u8* dest, u8 value, u64 size)
+{
+    u64 head = (32 - ((u64)dest & 31)) & 31;
+    memset(dest, value, head);
+    dest += head;
+    size -= head;
+
+    __m256i v = _mm256_set1_epi8((char)value);
+    for (; size >= 128; size -= 128, dest += 128)
+    {
+        _mm256_stream_si256((__m256i*)dest, v);
+        _mm256_stream_si256((__m256i*)(dest + 32), v);
+        _mm256_stream_si256((__m256i*)(dest + 64), v);
+        _mm256_stream_si256((__m256i*)(dest + 96), v);
+    }
+    _mm_sfence();
+    memset(dest, value, size);
+}
+
+static b8 cpu_has_avx2()
+{
+    u32 eax, ebx, ecx, edx;
+    if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+        return FALSE;
+
+    // the OS must save the ymm registers (OSXSAVE + XCR0 bits 1 and 2), not just the cpu support them.
+    const u32 osxsave = 1u << 27;
+    const u32 avx = 1u << 28;
+    if ((ecx & (osxsave | avx)) != (osxsave | avx))
+        return FALSE;
+
+    u32 xcr0_lo, xcr0_hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    if ((xcr0_lo & 0x6) != 0x6)
+        return FALSE;
+
+    if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+        return FALSE;
+    return (ebx & (1u << 5)) != 0;
+}
+#endif
+
+static void stream_generic_copy(u8* dest, const u8* source, u64 size)
+{
+    memcpy(dest, source, size);
+}
+
+static void stream_generic_set(u8* dest, u8 value, u64 size)
+{
+    memset(dest, value, size);
+}
+
+static void stream_resolve()
+{
+    pfn_stream_copy copy = stream_generic_copy;
+    pfn_stream_set set = stream_generic_set;
+    const char* isa = "none";
+
+#if PLATFORM_MEMORY_X64
+    // SSE2 is part of x86-64.
+    copy = stream_copy_sse2;
+    set = stream_set_sse2;
+    isa = "SSE2";
+    if (cpu_has_avx2())
+    {
+        copy = stream_copy_avx2;
+        set = stream_set_avx2;
+        isa = "AVX2";
+    }
+#endif
+
+    // racing threads resolve to the same functions.
+    __atomic_store_n(&stream_isa, isa, __ATOMIC_RELAXED);
+    __atomic_store_n(&stream_set, set, __ATOMIC_RELAXED);
+    __atomic_store_n(&stream_copy, copy, __ATOMIC_RELAXED);
+}
+
+static void stream_copy_resolve(u8* dest, const u8* source, u64 size)
+{
+    stream_resolve();
+    stream_copy(dest, source, size);
+}
+
+static void stream_set_resolve(u8* dest, u8 value, u64 size)
+{
+    stream_resolve();
+    stream_set(dest, value, size);
+}
+
+void* platform_stream_copy_mem(void* dest, const void* source, u64 size)
+{
+    if (size < PLATFORM_STREAM_THRESHOLD)
+        return memcpy(dest, source, size);
+
+    __atomic_load_n(&stream_copy, __ATOMIC_RELAXED)(dest, source, size);
+    return dest;
+}
+
+void* platform_stream_set_mem(void* dest, i32 value, u64 size)
+{
+    if (size < PLATFORM_STREAM_THRESHOLD)
+        return memset(dest, value, size);
+
+    __atomic_load_n(&stream_set, __ATOMIC_RELAXED)(dest, (u8)value, size);
+    return dest;
+}
+
+void* platform_stream_zero_mem(void* block, u64 size)
+{
+    return platform_stream_set_mem(block, 0, size);
+}
+
+const char* platform_stream_isa()
+{
+    if (!__atomic_load_n(&stream_isa, __ATOMIC_RELAXED))
+        stream_resolve();
+    return stream_isa;
+}
@@ -2,17 +2,18 @@
 
 #if ACPLATFORM_WINDOWS
 
-#include "container/dyn_array.h"
 #include "core/event.h"
 #include "core/input.h"
 #include "core/logger.h"
 
+#include <malloc.h>
 #include <stdlib.h>
 #include <windows.h>
 #include <windowsx.h>
 
 #include <vulkan/vulkan.h>
 #include <vulkan/vulkan_win32.h>
+#include "renderer/vulkan/vulkan_platform.h"
 #include "renderer/vulkan/vulkan_type.inl"
 
 // clock
@@ -140,14 +141,74 @@ b8 platform_push_msg(platform_state* plat_state)
     return TRUE;
 }
 
-void* platform_allocated(u64 size, b8 aligned) { return malloc(size); }
+void* platform_allocated(u64 size, b8 aligned)
+{
+    if (aligned)
+        return platform_allocated_aligned(size, PLATFORM_DEFAULT_ALIGNMENT);
+
+    return malloc(size);
+}
+
+void platform_free(void* block, b8 aligned)
+{
+    if (aligned)
+        platform_free_aligned(block);
+    else
+        free(block);
+}
 
-void platform_free(void* block, b8 aligned) { free(block); }
+void* platform_allocated_aligned(u64 size, u64 alignment) { return _aligned_malloc(size, alignment); }
+
+void platform_free_aligned(void* block) { _aligned_free(block); }
+
+u64 platform_page_size()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwPageSize;
+}
+
+void* platform_reserve_memory(u64 size) { return VirtualAlloc(0, size, MEM_RESERVE, PAGE_NOACCESS); }
+
+b8 platform_commit_memory(void* address, u64 size, b8 huge_page_hint)
+{
+    // NOTE: large pages on Windows must be requested at reserve time (and need SeLockMemoryPrivilege), hint is ignored.
+    return VirtualAlloc(address, size, MEM_COMMIT, PAGE_READWRITE) != 0;
+}
+
+void platform_decommit_memory(void* address, u64 size) { VirtualFree(address, size, MEM_DECOMMIT); }
+
+void platform_release_memory(void* address, u64 size) { VirtualFree(address, 0, MEM_RELEASE); }
+
+void* platform_allocate_large(u64 size, platform_page_kind* out_kind)
+{
+    size = (size + PLATFORM_LARGE_PAGE_SIZE - 1) & ~((u64)PLATFORM_LARGE_PAGE_SIZE - 1);
+
+    // large pages need SeLockMemoryPrivilege ("Lock pages in memory"), without it this fails.
+    u64 large_page = GetLargePageMinimum();
+    if (large_page && (size % large_page) == 0)
+    {
+        void* block = VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+        if (block)
+        {
+            *out_kind = PLATFORM_PAGE_HUGE;
+            return block;
+        }
+    }
+
+    // windows has no transparent huge pages, fall back to normal pages.
+    *out_kind = PLATFORM_PAGE_NORMAL;
+    return VirtualAlloc(0, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+void platform_free_large(void* block, u64 size) { VirtualFree(block, 0, MEM_RELEASE); }
 
 void* platform_zero_mem(void* block, u64 size) { return memset(block, 0, size); }
 
 void* platform_copy_mem(void* dest, const void* source, u64 size) { return memcpy(dest, source, size); }
 
+void* platform_move_mem(void* dest, const void* source, u64 size) { return memmove(dest, source, size); }
+
 void* platform_set_mem(void* dest, i32 value, u64 size) { return memset(dest, value, size); }
 
 void platform_console_write(const char* msg, u8 color)
@@ -187,9 +248,59 @@ f64 platform_get_absolute_time()
 
 void platform_sleep(u64 ms) { Sleep(ms); }
 
-void plaplatform_get_required_extension_name(const char*** names_dyn_array)
+typedef struct thread_start_info
+{
+    pfn_thread_start start;
+    void* param;
+} thread_start_info;
+
+// CreateThread wants DWORD WINAPI (LPVOID), run the engine signature from here.
+static DWORD WINAPI thread_trampoline(LPVOID arg)
+{
+    thread_start_info info = *(thread_start_info*)arg;
+    free(arg);
+    info.start(info.param);
+    return 0;
+}
+
+b8 platform_thread_create(pfn_thread_start start, void* param, platform_thread* out_thread)
+{
+    thread_start_info* info = malloc(sizeof(thread_start_info));
+    if (!info)
+        return FALSE;
+    info->start = start;
+    info->param = param;
+
+    HANDLE thread = CreateThread(0, 0, thread_trampoline, info, 0, 0);
+    if (!thread)
+    {
+        ACERROR("platform_thread_create - CreateThread failed.");
+        free(info);
+        return FALSE;
+    }
+    out_thread->handle = (u64)thread;
+    return TRUE;
+}
+
+void platform_thread_join(platform_thread* thread)
+{
+    WaitForSingleObject((HANDLE)thread->handle, INFINITE);
+    CloseHandle((HANDLE)thread->handle);
+    thread->handle = 0;
+}
+
+void platform_thread_yield() { SwitchToThread(); }
+
+u32 platform_processor_count()
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+}
+
+void plaplatform_get_required_extension_name(vulkan_name_list* names)
 {
-    ac_dyn_array_push_t(*names_dyn_array, &"VK_KHR_win32_surface");
+    ac_small_array_push_t(names, "VK_KHR_win32_surface");
 }
 
 b8 platform_create_vulkan_surface(platform_state* plat_state, vulkan_context* context)
@@ -0,0 +1,211 @@
+#include "vulkan_allocator.h"
+
+#include "core/acmemory.h"
+#include "core/logger.h"
+#include "memory/linear_alloc.h"
+
+/* PERF:
+ * Every block gets a small header right before the pointer given to the
+ * driver, since vkFree/vkRealloc do not pass the size back.
+ * +---------+---------------------+---------------------------+
+ * | padding | vulkan_alloc_header | memory returned to Vulkan |
+ * +---------+---------------------+---------------------------+
+ * |<------- offset (alignment) -->|<--------- size ---------->|
+ *
+ * COMMAND scope allocations only live for the duration of one vk* call, they
+ * come from a linear allocator that resets once none of them are alive.
+ */
+#define VULKAN_COMMAND_ARENA_SIZE (256 * 1024)
+#define VULKAN_ALLOC_MIN_ALIGNMENT 16
+// largest power of two the u16 alignment of ac_allocate_aligned_t and the header can hold.
+#define VULKAN_ALLOC_MAX_ALIGNMENT 0x8000
+
+typedef struct vulkan_alloc_header
+{
+    u64 size;
+    u16 offset;
+    u16 alignment;
+    u8 scope;
+    b8 from_arena;
+} vulkan_alloc_header;
+
+typedef struct vulkan_allocator_state
+{
+    linear_alloc command_arena;
+    u64 command_arena_live;
+    b8 command_arena_lock;
+
+    // driver internal (executable) memory, reported to us but not allocated by us.
+    // also recorded under the scope's tag so it shows up in the memory stats.
+    u64 internal_allocated;
+} vulkan_allocator_state;
+
+STATIC_ASSERT(sizeof(vulkan_alloc_header) <= VULKAN_ALLOC_MIN_ALIGNMENT, "vulkan_alloc_header must fit the minimum alignment");
+
+static vulkan_allocator_state state;
+
+static const mem_tag scope_tags[] = {
+    MEMTAG_VULKAN_COMMAND, MEMTAG_VULKAN_OBJECT, MEMTAG_VULKAN_CACHE, MEMTAG_VULKAN_DEVICE, MEMTAG_VULKAN_INSTANCE
+};
+
+static mem_tag scope_to_tag(VkSystemAllocationScope scope)
+{
+    return (u32)scope <= VK_SYSTEM_ALLOCATION_SCOPE_INSTANCE ? scope_tags[scope] : MEMTAG_RENDERER;
+}
+
+static void* arena_allocate(u64 total_size)
+{
+    // never wait on another thread here, fall back to the heap instead.
+    if (__atomic_test_and_set(&state.command_arena_lock, __ATOMIC_ACQUIRE))
+        return 0;
+
+    void* block = 0;
+    if (state.command_arena.allocated + total_size + LINEAR_ALLOC_ALIGNMENT <= state.command_arena.total_size)
+    {
+        block = ac_linear_alloc_allocate_t(&state.command_arena, total_size);
+        if (block)
+            state.command_arena_live++;
+    }
+
+    __atomic_clear(&state.command_arena_lock, __ATOMIC_RELEASE);
+    return block;
+}
+
+static void arena_free()
+{
+    while (__atomic_test_and_set(&state.command_arena_lock, __ATOMIC_ACQUIRE))
+    {
+    }
+
+    state.command_arena_live--;
+    if (state.command_arena_live == 0)
+        ac_linear_alloc_reset_t(&state.command_arena);
+
+    __atomic_clear(&state.command_arena_lock, __ATOMIC_RELEASE);
+}
+
+static VKAPI_ATTR void* VKAPI_CALL vulkan_alloc_allocation(void* user_data, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (size == 0)
+        return 0;
+
+    if (alignment > VULKAN_ALLOC_MAX_ALIGNMENT)
+    {
+        ACERROR("vulkan_alloc_allocation - alignment %llu is above the %u supported.", (u64)alignment, VULKAN_ALLOC_MAX_ALIGNMENT);
+        return 0;
+    }
+
+    u64 align = alignment > VULKAN_ALLOC_MIN_ALIGNMENT ? alignment : VULKAN_ALLOC_MIN_ALIGNMENT;
+    u64 offset = align;
+    u64 total_size = offset + size;
+
+    u8* block = 0;
+    b8 from_arena = FALSE;
+    if (scope == VK_SYSTEM_ALLOCATION_SCOPE_COMMAND && align == VULKAN_ALLOC_MIN_ALIGNMENT)
+    {
+        block = arena_allocate(total_size);
+        from_arena = block != 0;
+    }
+
+    if (!block)
+    {
+        if (align == VULKAN_ALLOC_MIN_ALIGNMENT)
+            block = ac_allocate_uninit_t(total_size, scope_to_tag(scope));
+        else
+            block = ac_allocate_aligned_t(total_size, (u16)align, scope_to_tag(scope));
+    }
+
+    if (!block)
+        return 0;
+
+    u8* memory = block + offset;
+    vulkan_alloc_header* header = (vulkan_alloc_header*)memory - 1;
+    header->size = size;
+    header->offset = (u16)offset;
+    header->alignment = (u16)align;
+    header->scope = (u8)scope;
+    header->from_arena = from_arena;
+    return memory;
+}
+
+static VKAPI_ATTR void VKAPI_CALL vulkan_alloc_free(void* user_data, void* memory)
+{
+    if (!memory)
+        return;
+
+    vulkan_alloc_header* header = (vulkan_alloc_header*)memory - 1;
+    u8* block = (u8*)memory - header->offset;
+    u64 total_size = header->offset + header->size;
+
+    if (header->from_arena)
+        arena_free();
+    else if (header->alignment == VULKAN_ALLOC_MIN_ALIGNMENT)
+        ac_free_t(block, total_size, scope_to_tag(header->scope));
+    else
+        ac_free_aligned_t(block, total_size, header->alignment, scope_to_tag(header->scope));
+}
+
+static VKAPI_ATTR void* VKAPI_CALL vulkan_alloc_reallocation(
+  void* user_data, void* original, size_t size, size_t alignment, VkSystemAllocationScope scope)
+{
+    if (!original)
+        return vulkan_alloc_allocation(user_data, size, alignment, scope);
+
+    if (size == 0)
+    {
+        vulkan_alloc_free(user_data, original);
+        return 0;
+    }
+
+    vulkan_alloc_header* header = (vulkan_alloc_header*)original - 1;
+    void* memory = vulkan_alloc_allocation(user_data, size, alignment, scope);
+    if (!memory)
+        return 0;
+
+    ac_copy_memory_t(memory, original, header->size < size ? header->size : size);
+    vulkan_alloc_free(user_data, original);
+    return memory;
+}
+
+static VKAPI_ATTR void VKAPI_CALL vulkan_alloc_internal_allocation(void* user_data,
+                                                                   size_t size,
+                                                                   VkInternalAllocationType allocation_type,
+                                                                   VkSystemAllocationScope scope)
+{
+    __atomic_fetch_add(&state.internal_allocated, size, __ATOMIC_RELAXED);
+    memory_record_external_allocate(size, scope_to_tag(scope));
+}
+
+static VKAPI_ATTR void VKAPI_CALL vulkan_alloc_internal_free(void* user_data,
+                                                             size_t size,
+                                                             VkInternalAllocationType allocation_type,
+                                                             VkSystemAllocationScope scope)
+{
+    __atomic_fetch_sub(&state.internal_allocated, size, __ATOMIC_RELAXED);
+    memory_record_external_free(size, scope_to_tag(scope));
+}
+
+void vulkan_allocator_create(VkAllocationCallbacks* out_callbacks)
+{
+    ac_zero_memory_t(&state, sizeof(state));
+    ac_linear_alloc_create_t("vulkan command", VULKAN_COMMAND_ARENA_SIZE, 0, &state.command_arena);
+
+    out_callbacks->pUserData = &state;
+    out_callbacks->pfnAllocation = vulkan_alloc_allocation;
+    out_callbacks->pfnReallocation = vulkan_alloc_reallocation;
+    out_callbacks->pfnFree = vulkan_alloc_free;
+    out_callbacks->pfnInternalAllocation = vulkan_alloc_internal_allocation;
+    out_callbacks->pfnInternalFree = vulkan_alloc_internal_free;
+}
+
+void vulkan_allocator_destroy(VkAllocationCallbacks* callbacks)
+{
+    if (state.command_arena_live != 0)
+        ACWARN("Vulkan allocator destroyed with %llu command scope allocations alive.", state.command_arena_live);
+
+    if (state.internal_allocated != 0)
+        ACDEBUG("Vulkan driver still reports %lluB of internal allocations.", state.internal_allocated);
+
+    ac_linear_alloc_destroy_t(&state.command_arena);
+    ac_zero_memory_t(callbacks, sizeof(VkAllocationCallbacks));
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "vulkan_type.inl"
+
+// Fill callbacks that route Vulkan host allocations through the engine allocator.
+void vulkan_allocator_create(VkAllocationCallbacks* out_callbacks);
+
+// Call after the instance is destroyed.
+void vulkan_allocator_destroy(VkAllocationCallbacks* callbacks);
@@ -1,6 +1,7 @@
 #include "vulkan_backend.h"
 
 // #include "vulkan/vulkan_core.h"
+#include "vulkan_allocator.h"
 #include "vulkan_command_buffer.h"
 #include "vulkan_device.h"
 #include "vulkan_fence.h"
@@ -17,6 +18,8 @@
 #include "core/logger.h"
 
 #include "container/dyn_array.h"
+#include "container/hashmap.h"
+#include "memory/stack_alloc.h"
 
 #include "platform/platform.h"
 
@@ -41,7 +44,8 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     context.find_memory_index = find_memory_index;
 
     // Custom allocator.
-    context.allocator = 0;
+    vulkan_allocator_create(&context.allocator_callbacks);
+    context.allocator = &context.allocator_callbacks;
 
     // BUG: somehow framebuffer size cannot setup correctly.
     application_get_framebuffer_size(&cache_framebuffer_width, &cache_framebuffer_height);
@@ -62,69 +66,78 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     create_info.pApplicationInfo = &app_info;
 
     // obtain requirement extension
-    const char** required_extension = ac_dyn_array_create_t(const char*);
-    ac_dyn_array_push_t(required_extension, &VK_KHR_SURFACE_EXTENSION_NAME); // Generic surface extension
-    platform_get_required_extension_name(&required_extension);               // platform specific
+    vulkan_name_list required_extension;
+    ac_small_array_init_t(&required_extension);
+    ac_small_array_push_t(&required_extension, VK_KHR_SURFACE_EXTENSION_NAME); // Generic surface extension
+    platform_get_required_extension_name(&required_extension);                 // platform specific
 
 #if defined(_DEBUG)
-    ac_dyn_array_push_t(required_extension, &VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    ac_small_array_push_t(&required_extension, VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
 
     ACDEBUG("Require Extensions:");
-    u32 length = ac_dyn_array_length_t(required_extension);
+    u32 length = ac_small_array_length_t(&required_extension);
     for (u32 i = 0; i < length; ++i)
     {
-        ACDEBUG(required_extension[i]);
+        ACDEBUG(ac_small_array_data_t(&required_extension)[i]);
     }
 #endif
 
-    create_info.enabledExtensionCount = ac_dyn_array_length_t(required_extension);
-    create_info.ppEnabledExtensionNames = required_extension;
+    create_info.enabledExtensionCount = ac_small_array_length_t(&required_extension);
+    create_info.ppEnabledExtensionNames = ac_small_array_data_t(&required_extension);
 
     // check for validation layer
-    const char** required_validation_layer_name = 0;
-    u32 required_validation_layer_count = 0;
+    vulkan_name_list required_validation_layer;
+    ac_small_array_init_t(&required_validation_layer);
 
 #if defined(_DEBUG)
     ACINFO("Validation layer enabled. Enumerating...");
 
     // list of validation layer required
-    required_validation_layer_name = ac_dyn_array_create_t(const char*);
-    ac_dyn_array_push_t(required_validation_layer_name, &"VK_LAYER_KHRONOS_validation");
-    required_validation_layer_count = ac_dyn_array_length_t(required_validation_layer_name);
+    ac_small_array_push_t(&required_validation_layer, "VK_LAYER_KHRONOS_validation");
+    const char** required_validation_layer_name = ac_small_array_data_t(&required_validation_layer);
+    u32 required_validation_layer_count = ac_small_array_length_t(&required_validation_layer);
 
     u32 avail_layer_count = 0;
     VK_CHECK(vkEnumerateInstanceLayerProperties(&avail_layer_count, 0));
-    VkLayerProperties* available_layers = ac_dyn_array_reserved_t(VkLayerProperties, avail_layer_count);
+    stack_alloc* stack = ac_stack_alloc_thread_t();
+    stack_alloc_marker marker = ac_stack_alloc_get_marker_t(stack);
+    VkLayerProperties* available_layers = ac_stack_alloc_push_t(stack, sizeof(VkLayerProperties) * avail_layer_count);
     VK_CHECK(vkEnumerateInstanceLayerProperties(&avail_layer_count, available_layers));
 
+    // index available layers by name, keys point into available_layers.
+    hashmap available_layer_set;
+    ac_hashmap_create_t(sizeof(const char*), 0, avail_layer_count, ac_hashmap_hash_string_t, ac_hashmap_equal_string_t, &available_layer_set);
+    for (u32 j = 0; j < avail_layer_count; ++j)
+    {
+        const char* name = available_layers[j].layerName;
+        ac_hashmap_insert_t(&available_layer_set, &name, 0);
+    }
+
     // Verify all required layers are available.
     for (u32 i = 0; i < required_validation_layer_count; ++i)
     {
-        b8 found = FALSE;
-        for (u32 j = 0; j < avail_layer_count; ++j)
-        {
-            if (string_equal(required_validation_layer_name[i], available_layers[j].layerName))
-            {
-                found = TRUE;
-                ACINFO("Found");
-                break;
-            }
-        }
-        if (!found)
+        if (!ac_hashmap_find_t(&available_layer_set, &required_validation_layer_name[i]))
         {
             ACFATAL("Required validation layer is missing: %s", required_validation_layer_name[i]);
+            ac_hashmap_destroy_t(&available_layer_set);
+            ac_stack_alloc_pop_to_marker_t(stack, marker);
             // break;
             //  HACK: I'm cheating here!!!
             return TRUE;
         }
     }
+    ac_hashmap_destroy_t(&available_layer_set);
+    ac_stack_alloc_pop_to_marker_t(stack, marker);
     ACINFO("All required validation layers are present.");
 #endif
 
-    create_info.enabledLayerCount = required_validation_layer_count;
-    create_info.ppEnabledLayerNames = required_validation_layer_name;
+    create_info.enabledLayerCount = ac_small_array_length_t(&required_validation_layer);
+    create_info.ppEnabledLayerNames = ac_small_array_data_t(&required_validation_layer);
 
     VK_CHECK(vkCreateInstance(&create_info, context.allocator, &context.instance));
+    // the instance copies the names, the lists are only needed for the create call.
+    ac_small_array_destroy_t(&required_extension);
+    ac_small_array_destroy_t(&required_validation_layer);
     ACINFO("Vulkan Instance success!");
 
 #if defined(_DEBUG)
@@ -177,7 +190,8 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
     // Create sync object
     context.image_available_semaphores = ac_dyn_array_reserved_t(VkSemaphore, context.swapchain.max_frame_in_flight);
     context.queue_complete_semaphores = ac_dyn_array_reserved_t(VkSemaphore, context.swapchain.max_frame_in_flight);
-    context.in_flight_fences = ac_dyn_array_reserved_t(vulkan_fence, context.swapchain.max_frame_in_flight);
+    ac_slot_map_create_type_t(vulkan_fence, context.swapchain.max_frame_in_flight, MEMTAG_RENDERER, &context.fences);
+    context.in_flight_fences = ac_dyn_array_reserved_t(slot_handle, context.swapchain.max_frame_in_flight);
     for (u8 i = 0; i < context.swapchain.max_frame_in_flight; ++i)
     {
         VkSemaphoreCreateInfo semaphore_create_info = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
@@ -186,14 +200,16 @@ b8 vulkan_renderer_backend_initialize(renderer_backend* backend, const char* app
 
         // this was indicator that first time frame already been "rendered"
         // to prevent application from waiting
-        vulkan_fence_create(&context, TRUE, &context.in_flight_fences[i]);
+        vulkan_fence fence;
+        vulkan_fence_create(&context, TRUE, &fence);
+        context.in_flight_fences[i] = ac_slot_map_insert_t(&context.fences, &fence);
     }
 
-    // NOTE: in flight fence SHOULD NOT EXIST yet!!!. These are stored in pointer because initial state should be 0.
-    context.images_in_flight = ac_dyn_array_reserved_t(vulkan_fence, context.swapchain.image_count);
+    // NOTE: in flight fence SHOULD NOT EXIST yet!!!. These are stored as handles because initial state should be invalid.
+    context.images_in_flight = ac_dyn_array_reserved_t(slot_handle, context.swapchain.image_count);
     for (u32 i = 0; i < context.swapchain.image_count; ++i)
     {
-        context.images_in_flight[i] = 0;
+        context.images_in_flight[i] = SLOT_HANDLE_INVALID;
     }
 
     ACINFO("Vulkan renderer initialized");
@@ -217,8 +233,9 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend)
             vkDestroySemaphore(context.device.logical_device, context.queue_complete_semaphores[i], context.allocator);
             context.queue_complete_semaphores[i] = 0;
         }
-        vulkan_fence_destroy(&context, &context.in_flight_fences[i]);
+        vulkan_fence_destroy(&context, ac_slot_map_get_t(&context.fences, context.in_flight_fences[i]));
     }
+    ac_slot_map_destroy_t(&context.fences);
     ac_dyn_array_destroy_t(context.image_available_semaphores);
     context.image_available_semaphores = 0;
     ac_dyn_array_destroy_t(context.queue_complete_semaphores);
@@ -269,6 +286,9 @@ void vulkan_renderer_backend_shutdown(renderer_backend* backend)
 
     ACDEBUG("Destroy Vulkan Instance...");
     vkDestroyInstance(context.instance, context.allocator);
+
+    vulkan_allocator_destroy(&context.allocator_callbacks);
+    context.allocator = 0;
 }
 
 void vulkan_renderer_backend_on_resize(renderer_backend* backend, u16 width, u16 height)
@@ -315,7 +335,7 @@ b8 vulkan_renderer_backend_begin_frame(renderer_backend* backend, f32 delta_time
     }
 
     // wait for the execute of the current frame complete.
-    if (!vulkan_fence_wait(&context, &context.in_flight_fences[context.current_frame], UINT64_MAX))
+    if (!vulkan_fence_wait(&context, ac_slot_map_get_t(&context.fences, context.in_flight_fences[context.current_frame]), UINT64_MAX))
     {
         ACWARN("In-flight fence wait failure!");
         return FALSE;
@@ -367,14 +387,17 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
     vulkan_renderpass_end(command_buffer, &context.main_renderpass);
     vulkan_command_buffer_end(command_buffer);
 
-    if (context.images_in_flight[context.image_index] != VK_NULL_HANDLE)
-        vulkan_fence_wait(&context, context.images_in_flight[context.image_index], UINT64_MAX);
+    // a stale or invalid handle means no frame is using the image.
+    vulkan_fence* image_fence = ac_slot_map_get_t(&context.fences, context.images_in_flight[context.image_index]);
+    if (image_fence)
+        vulkan_fence_wait(&context, image_fence, UINT64_MAX);
 
     // mark image fence as in-use by this frame
-    context.images_in_flight[context.image_index] = &context.in_flight_fences[context.current_frame];
+    context.images_in_flight[context.image_index] = context.in_flight_fences[context.current_frame];
 
     // reset fence for use the next frame
-    vulkan_fence_reset(&context, &context.in_flight_fences[context.current_frame]);
+    vulkan_fence* frame_fence = ac_slot_map_get_t(&context.fences, context.in_flight_fences[context.current_frame]);
+    vulkan_fence_reset(&context, frame_fence);
 
     // submit queue and wait for operation to complete, then executed
     VkSubmitInfo submit_info = { VK_STRUCTURE_TYPE_SUBMIT_INFO };
@@ -390,7 +413,7 @@ b8 vulkan_renderer_backend_end_frame(renderer_backend* backend, f32 delta_time)
     VkPipelineStageFlags flags[1] = { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT };
     submit_info.pWaitDstStageMask = flags;
 
-    VkResult result = vkQueueSubmit(context.device.graphics_queue, 1, &submit_info, context.in_flight_fences[context.current_frame].handle);
+    VkResult result = vkQueueSubmit(context.device.graphics_queue, 1, &submit_info, frame_fence->handle);
     if (result != VK_SUCCESS)
     {
         ACERROR("vkQueueSubmit failed with result: %s", vulkan_result_string(result, TRUE));
@@ -508,7 +531,7 @@ b8 recreate_swapchain(renderer_backend* backend)
     vkDeviceWaitIdle(context.device.logical_device);
     for (u32 i = 0; i < context.swapchain.image_count; ++i)
     {
-        context.images_in_flight[i] = 0;
+        context.images_in_flight[i] = SLOT_HANDLE_INVALID;
     }
 
     // requeery swapchain support
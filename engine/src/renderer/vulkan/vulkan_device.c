@@ -1,8 +1,9 @@
 #include "vulkan_device.h"
-#include "container/dyn_array.h"
+#include "vulkan_platform.h"
 #include "core/acmemory.h"
 #include "core/astring.h"
 #include "core/logger.h"
+#include "memory/stack_alloc.h"
 
 typedef struct vulkan_physical_device_requirement
 {
@@ -11,7 +12,7 @@ typedef struct vulkan_physical_device_requirement
     b8 compute;
     b8 transfer;
 
-    const char** device_extension_name;
+    vulkan_name_list device_extension_name;
     b8 sampler_anisotrophy;
     b8 discrete_gpu;
 } vulkan_physical_device_requirement;
@@ -223,7 +224,13 @@ b8 select_physical_device(vulkan_context* context)
         return FALSE;
     }
 
-    VkPhysicalDevice physical_device[physical_device_count];
+    // temporaries below live on the thread stack, popped once a device is picked.
+    stack_alloc* stack = ac_stack_alloc_thread_t();
+    stack_alloc_marker marker = ac_stack_alloc_get_marker_t(stack);
+
+    VkPhysicalDevice* physical_device = ac_stack_alloc_push_t(stack, sizeof(VkPhysicalDevice) * physical_device_count);
+    if (!physical_device)
+        return FALSE;
     VK_CHECK(vkEnumeratePhysicalDevices(context->instance, &physical_device_count, physical_device));
     for (u32 i = 0; i < physical_device_count; ++i)
     {
@@ -247,8 +254,7 @@ b8 select_physical_device(vulkan_context* context)
         requirement.sampler_anisotrophy = TRUE;
 
         requirement.discrete_gpu = FALSE; // HACK: I'm cheating in this line. the correct value was TRUE
-        requirement.device_extension_name = ac_dyn_array_create_t(const char*);
-        ac_dyn_array_push_t(requirement.device_extension_name, &VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+        ac_small_array_push_t(&requirement.device_extension_name, VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
         vulkan_physical_device_queue_family_info queue_info = {};
         b8 result = physical_device_meet_requirement(
@@ -310,6 +316,8 @@ b8 select_physical_device(vulkan_context* context)
         }
     }
 
+    ac_stack_alloc_pop_to_marker_t(stack, marker);
+
     if (!context->device.physical_device)
     {
         ACERROR("No physical device found to meet the requirement.");
@@ -347,9 +355,15 @@ b8 physical_device_meet_requirement(VkPhysicalDevice device,
     //     return TRUE;
     // }
 
+    // nested in select_physical_device's scope, everything pushed here is popped before returning.
+    stack_alloc* stack = ac_stack_alloc_thread_t();
+    stack_alloc_marker marker = ac_stack_alloc_get_marker_t(stack);
+
     u32 queue_fam_count = 0;
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_fam_count, 0);
-    VkQueueFamilyProperties queue_fam[queue_fam_count];
+    VkQueueFamilyProperties* queue_fam = ac_stack_alloc_push_t(stack, sizeof(VkQueueFamilyProperties) * queue_fam_count);
+    if (!queue_fam)
+        return FALSE;
     vkGetPhysicalDeviceQueueFamilyProperties(device, &queue_fam_count, queue_fam);
 
     ACTRACE("Graphics | Present | Compute | Transfer | Name");
@@ -388,6 +402,7 @@ b8 physical_device_meet_requirement(VkPhysicalDevice device,
             out_queue_family_info->present_family_index = i;
         }
     }
+    ac_stack_alloc_pop_to_marker_t(stack, marker);
 
     ACTRACE("        %d |        %d |        %d |        %d | %s",
             out_queue_family_info->graphics_family_index != -1,
@@ -427,23 +442,26 @@ b8 physical_device_meet_requirement(VkPhysicalDevice device,
             return FALSE;
         }
 
-        if (requirement->device_extension_name)
+        if (ac_small_array_length_t(&requirement->device_extension_name))
         {
             u32 available_extension_count = 0;
             VkExtensionProperties* available_extension = 0;
             VK_CHECK(vkEnumerateDeviceExtensionProperties(device, 0, &available_extension_count, 0));
             if (available_extension_count != 0)
             {
-                available_extension = ac_allocate_t(sizeof(VkExtensionProperties) * available_extension_count, MEMTAG_RENDERER);
+                available_extension = ac_stack_alloc_push_t(stack, sizeof(VkExtensionProperties) * available_extension_count);
+                if (!available_extension)
+                    return FALSE;
                 VK_CHECK(vkEnumerateDeviceExtensionProperties(device, 0, &available_extension_count, available_extension));
 
-                u32 required_extension_count = ac_dyn_array_length_t(requirement->device_extension_name);
+                const char* const* required_extension = ac_small_array_data_t(&requirement->device_extension_name);
+                u32 required_extension_count = ac_small_array_length_t(&requirement->device_extension_name);
                 for (u32 i = 0; i < required_extension_count; ++i)
                 {
                     b8 found = FALSE;
                     for (u32 j = 0; j < available_extension_count; ++j)
                     {
-                        if (string_equal(requirement->device_extension_name[i], available_extension[j].extensionName))
+                        if (string_equal(required_extension[i], available_extension[j].extensionName))
                         {
                             found = TRUE;
                             break;
@@ -451,13 +469,13 @@ b8 physical_device_meet_requirement(VkPhysicalDevice device,
                     }
                     if (!found)
                     {
-                        ACINFO("Required extension not found: '%s'. Skip device", requirement->device_extension_name[i]);
-                        ac_free_t(available_extension, sizeof(VkExtensionProperties) * available_extension_count, MEMTAG_RENDERER);
+                        ACINFO("Required extension not found: '%s'. Skip device", required_extension[i]);
+                        ac_stack_alloc_pop_to_marker_t(stack, marker);
                         return FALSE;
                     }
                 }
             }
-            ac_free_t(available_extension, sizeof(VkExtensionProperties) * available_extension_count, MEMTAG_RENDERER);
+            ac_stack_alloc_pop_to_marker_t(stack, marker);
         }
         if (requirement->sampler_anisotrophy && !feature->samplerAnisotropy)
         {
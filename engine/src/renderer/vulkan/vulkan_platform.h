@@ -1,12 +1,16 @@
 #pragma once
 
 #include "define.h"
+#include "container/small_array.h"
 
 struct platform_state;
 struct vulkan_context;
 
 b8 platform_create_vulkan_surface(struct platform_state* plat_state, struct vulkan_context* context);
 
-// Append names of required extension to names dynamic array
-void platform_get_required_extension_name(const char*** names_dyn_array);
+// extension/layer name lists stay inline up to 8 names, which covers every list the backend builds.
+typedef SMALL_ARRAY(const char*, 8) vulkan_name_list;
+
+// Append names of required extension to names
+void platform_get_required_extension_name(vulkan_name_list* names);
 
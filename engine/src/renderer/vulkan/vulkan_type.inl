@@ -1,5 +1,6 @@
 #pragma once
 
+#include "container/slot_map.h"
 #include "core/assertion.h"
 #include "define.h"
 // #include "core/astring.h"
@@ -126,6 +127,7 @@ typedef struct vulkan_context
 
     VkInstance instance;
     VkAllocationCallbacks* allocator;
+    VkAllocationCallbacks allocator_callbacks; // engine allocator, "allocator" points here.
     VkSurfaceKHR surface;
 
 #if defined(_DEBUG)
@@ -141,9 +143,10 @@ typedef struct vulkan_context
     VkSemaphore* image_available_semaphores; // dynamic array
     VkSemaphore* queue_complete_semaphores;  // dynamic array
 
+    slot_map fences; // every vulkan_fence, referenced by slot_handle
     u32 in_flight_fence_count;
-    vulkan_fence* in_flight_fences;
-    vulkan_fence** images_in_flight; // hold pointer to fences
+    slot_handle* in_flight_fences; // dynamic array, fence of each frame in flight
+    slot_handle* images_in_flight; // dynamic array, fence of the frame using the image or SLOT_HANDLE_INVALID
 
     u32 image_index;
     i32 current_frame;